@@ -1,45 +1,115 @@
 #pragma once
-#include <mutex>
+#include <atomic>
 #include <array>
 #include <vector>
 #include <fstream>
+#include <iomanip>
 #include <algorithm>
 #include <random>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
 
 #include "Genome.hpp"
 #include "DandelifeonEngine.hpp"
+#include "SharedRegion.hpp"
+#include "ParetoFront.hpp"
 
 
 namespace Dandelifeon {
+    // Fixed-width fields: the same cells are read by other builds through the shared file
     struct ArchiveCell {
         Genome genome;
-        long mana = -1;
-        int blocks = 999;
-        int usage_count = 0;
+        int32_t mana = -1;
+        int32_t blocks = 999;
+        int32_t usage_count = 0;
         bool occupied = false;
     };
 
+    static_assert(std::is_trivially_copyable_v<ArchiveCell>, "ArchiveCell is copied raw into shared memory");
+
+    // Spinlock living inside the storage itself, so it works across processes too.
+    // The flag holds the owner's process id: a process killed inside the lock leaves its id
+    // behind, and whoever waits on it takes the lock over once that process is gone.
+    // lock() returns true on such a takeover: the dead owner may have left its update half done
+    struct StorageLock {
+        std::atomic<uint32_t> flag; // 0 - free
+
+        bool lock() {
+            const uint32_t me = currentProcessId();
+            uint32_t spins = 0;
+
+            while (true) {
+                uint32_t owner = 0;
+                if (flag.compare_exchange_weak(owner, me, std::memory_order_acquire))
+                    return false;
+
+                if (owner != 0 && owner != me && ++spins % 1024 == 0 && !processAlive(owner)
+                    && flag.compare_exchange_strong(owner, me, std::memory_order_acquire))
+                    return true;
+
+                std::this_thread::yield();
+            }
+        }
+
+        void unlock() { flag.store(0, std::memory_order_release); }
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared archive needs address-free atomics");
+
+    // Binary layout of the archive. Bump ARCHIVE_LAYOUT_VERSION whenever it (or Genome) changes.
+    // The first five fields are frozen so any build can read a file's header and turn it away;
+    // new fields go after them
+    constexpr uint32_t ARCHIVE_MAGIC = 0x4C45444E; // "NDEL"
+    constexpr uint32_t ARCHIVE_LAYOUT_VERSION = 4;
+
+    struct ArchiveStorage {
+        uint32_t magic;
+        uint32_t layout_version;
+        uint32_t storage_size;
+        std::atomic<uint32_t> state; // 2 - laid out, anything else - not yet (or the one laying it out died)
+        StorageLock lock;
+
+        uint32_t descriptor_ids[2]; // DescriptorKernel::id of the X and Y axes
+
+        int32_t global_best_mana;
+        int32_t global_best_blocks;
+
+        int32_t occupied_count;
+        uint16_t occupied_indices[400]; // ix * 20 + iy
+
+        ArchiveCell grid[20][20];
+    };
+
     class Archive {
     private:
-        std::array<std::array<ArchiveCell, 20>, 20> grid;
-        std::vector<std::pair<int, int>> occupied_indices;
-        std::mutex archive_mtx;
+        std::unique_ptr<ArchiveStorage> local_store;
+        SharedRegion region;
+        ArchiveStorage* store = nullptr;
 
-        long global_best_mana = 0;
-        int global_best_blocks = 999;
+        uint32_t descriptor_ids[2] = { 0, 1 }; // density, row_spread
 
-        void saveToDisk(const Genome& gen, const SimulationResult& res, int ix, int iy) {
-            std::ofstream f("absolute_leader.txt");
-            if (!f.is_open()) return;
+        // Trade-off curve of this process, optionally also one per niche
+        ParetoFront front;
+        std::vector<ParetoFront> niche_fronts;
+        std::mutex front_mtx;
+        bool front_dirty = false; // changed since the last saveFront()
+        std::string front_path = "pareto_front.txt";
 
-            f << "=== DANDELIFEON ABSOLUTE LEADER ===\n";
-            f << "Mana Score: " << res.mana << "\n";
-            f << "Life Blocks: " << res.initial_blocks << "\n";
-            f << "Fitness (Mana/Block): " << res.fitness << "\n";
-            f << "Archive Position: [X:" << ix << ", Y:" << iy << "]\n";
-            f << "Symmetric: " << (gen.symmetric ? "YES" : "NO") << "\n";
-            f << "-----------------------------------\n";
+        // Last record written to absolute_leader.txt by this process
+        std::mutex leader_mtx;
+        long leader_mana = 0;
+        int leader_blocks = 999;
+
+        static void nicheOf(const SimulationResult& res, int& ix, int& iy) {
+            // Descriptors come in 0.0 ... 1.0 -> (0 ... 19)
+            ix = std::clamp((int)(res.pheno_x * 20), 0, 19);
+            iy = std::clamp((int)(res.pheno_y * 20), 0, 19);
+        }
 
+        static void writeBoard(std::ostream& f, const Genome& gen) {
             Bitboard life = gen.getLifeBoard();
             Bitboard walls = gen.getObstaclesBoard();
 
@@ -57,68 +127,359 @@ namespace Dandelifeon {
                 }
                 f << "\n";
             }
+        }
+
+        static void writeFrontTable(std::ostream& f, const std::vector<ParetoPoint>& points) {
+            f << "Mana    Blocks  Ticks\n";
+            for (const auto& p : points)
+                f << std::left << std::setw(8) << p.mana << std::setw(8) << p.blocks << p.ticks << "\n";
+        }
+
+        void writeFront(const std::vector<ParetoPoint>& points, const std::vector<std::vector<ParetoPoint>>& niches) const {
+            std::ofstream f(front_path);
+            if (!f.is_open()) return;
+
+            f << "=== DANDELIFEON PARETO FRONT (mana max, blocks min, ticks min) ===\n";
+            f << "Points: " << points.size() << "\n";
+            writeFrontTable(f, points);
+
+            for (const auto& p : points) {
+                f << "-----------------------------------\n";
+                f << "Mana: " << p.mana << " | Blocks: " << p.blocks << " | Ticks: " << p.ticks
+                    << " | Symmetric: " << (p.genome.symmetric ? "YES" : "NO") << "\n";
+                writeBoard(f, p.genome);
+            }
+
+            if (!niches.empty()) {
+                f << "=== NICHE FRONTS ===\n";
+                for (int i = 0; i < 400; ++i) {
+                    if (niches[i].empty()) continue;
+                    f << "[X:" << i / 20 << ", Y:" << i % 20 << "]";
+                    for (const auto& p : niches[i])
+                        f << "  " << p.mana << "/" << p.blocks << "/" << p.ticks;
+                    f << "\n";
+                }
+            }
+        }
+
+        // Magic goes in last: a header with magic set always has its version and size too
+        void initStorage(ArchiveStorage& s) const {
+            s.layout_version = ARCHIVE_LAYOUT_VERSION;
+            s.storage_size = (uint32_t)sizeof(ArchiveStorage);
+            s.descriptor_ids[0] = descriptor_ids[0];
+            s.descriptor_ids[1] = descriptor_ids[1];
+            s.global_best_mana = 0;
+            s.global_best_blocks = 999;
+            s.occupied_count = 0;
+
+            for (auto& row : s.grid)
+                for (auto& cell : row)
+                    cell = ArchiveCell();
+
+            std::atomic_thread_fence(std::memory_order_release);
+            s.magic = ARCHIVE_MAGIC;
+        }
+
+        bool foreignHeader(const ArchiveStorage& s) const {
+            return s.magic != ARCHIVE_MAGIC || s.layout_version != ARCHIVE_LAYOUT_VERSION
+                || s.storage_size != sizeof(ArchiveStorage);
+        }
+
+        // Holds the storage lock, repairing what a dead previous owner may have left behind
+        class StoreLock {
+        private:
+            Archive& archive;
+
+        public:
+            explicit StoreLock(Archive& a) : archive(a) {
+                if (archive.store->lock.lock()) archive.repairOccupied();
+            }
+            ~StoreLock() { archive.store->lock.unlock(); }
+
+            StoreLock(const StoreLock&) = delete;
+            StoreLock& operator=(const StoreLock&) = delete;
+        };
+
+        // A process killed in the middle of submit can leave the occupied list out of step with
+        // the grid. Caller holds the lock
+        void repairOccupied() {
+            bool ok = store->occupied_count >= 0 && store->occupied_count <= 400;
+            for (int i = 0; ok && i < store->occupied_count; ++i) {
+                int pos = store->occupied_indices[i];
+                ok = pos < 400 && store->grid[pos / 20][pos % 20].occupied;
+            }
+            if (ok) return;
+
+            store->occupied_count = 0;
+            for (int pos = 0; pos < 400; ++pos)
+                if (store->grid[pos / 20][pos % 20].occupied)
+                    store->occupied_indices[store->occupied_count++] = (uint16_t)pos;
+        }
+
+        // Called with no lock held. Writers that lost the race to a better record skip the write
+        void saveToDisk(const Genome& gen, const SimulationResult& res, int ix, int iy) {
+            std::lock_guard<std::mutex> leader_lock(leader_mtx);
+            if (res.mana < leader_mana || (res.mana == leader_mana && res.initial_blocks >= leader_blocks))
+                return;
+            leader_mana = res.mana;
+            leader_blocks = res.initial_blocks;
+
+            std::ofstream f("absolute_leader.txt");
+            if (!f.is_open()) return;
+
+            f << "=== DANDELIFEON ABSOLUTE LEADER ===\n";
+            f << "Mana Score: " << res.mana << "\n";
+            f << "Life Blocks: " << res.initial_blocks << "\n";
+            f << "Fitness (Mana/Block): " << res.fitness << "\n";
+            f << "Archive Position: [X:" << ix << ", Y:" << iy << "]\n";
+            f << "Symmetric: " << (gen.symmetric ? "YES" : "NO") << "\n";
+            f << "-----------------------------------\n";
+
+            writeBoard(f, gen);
+
+            std::lock_guard<std::mutex> lock(front_mtx);
+            if (!front.empty()) {
+                f << "-----------------------------------\n";
+                f << "Pareto front (full boards in " << front_path << "):\n";
+                writeFrontTable(f, front.points());
+            }
             f.close();
         }
 
     public:
-        void submit(const Genome& gen, const SimulationResult& res) {
-            // X: Density (0.0 ... 1.0) -> (0 ... 19)
-            // Y: Distance (0.0 ... 18.0) -> (0 ... 19)
-            int ix = std::clamp((int)(res.pheno_x * 20), 0, 19);
-            int iy = std::clamp((int)((res.pheno_y / 18.0) * 20), 0, 19);
+        Archive() : local_store(std::make_unique<ArchiveStorage>()) {
+            store = local_store.get();
+            store->lock.flag.store(0);
+            initStorage(*store);
+            store->state.store(2);
+        }
 
-            std::lock_guard<std::mutex> lock(archive_mtx);
-            ArchiveCell& cell = grid[ix][iy];
+        // Which descriptors the niches are made of. Call before attachShared, a shared file only
+        // takes processes that use the same pair
+        void setDescriptors(uint32_t x_id, uint32_t y_id) {
+            descriptor_ids[0] = x_id;
+            descriptor_ids[1] = y_id;
 
-            bool is_global_record = false;
-            // Mana -> blocks. But now fitness-function search mana per blocks and this is not relevant
-            if (res.mana > global_best_mana) {
-                global_best_mana = res.mana;
-                global_best_blocks = res.initial_blocks;
-                is_global_record = true;
+            if (local_store) {
+                local_store->descriptor_ids[0] = x_id;
+                local_store->descriptor_ids[1] = y_id;
             }
-            else if (res.mana == global_best_mana && res.initial_blocks < global_best_blocks) {
-                global_best_blocks = res.initial_blocks;
-                is_global_record = true;
+        }
+
+        // Moves the archive into a file mapped by every solver process on the host.
+        // A fresh file is laid out under the storage lock, so if that process dies half-way
+        // the next one takes the lock over and lays it out again. The first process on the
+        // file also clears whatever lock owner the last run left behind
+        bool attachShared(const std::string& path) {
+            if (!region.open(path, sizeof(ArchiveStorage)))
+                return false;
+
+            auto* shared = static_cast<ArchiveStorage*>(region.data());
+
+            // Written by a different build: its state and lock may sit anywhere, don't wait on them
+            if (shared->magic != 0 && foreignHeader(*shared)) {
+                region.close();
+                return false;
             }
 
-            bool replace_in_cell = false;
-            if (!cell.occupied || cell.usage_count >= 3) {
-                replace_in_cell = true;
+            if (region.lockExclusive())
+                shared->lock.flag.store(0);
+            region.lockShared();
+
+            if (shared->state.load(std::memory_order_acquire) != 2) {
+                std::lock_guard<StorageLock> lock(shared->lock);
+                if (shared->state.load(std::memory_order_relaxed) != 2) {
+                    initStorage(*shared);
+                    shared->state.store(2, std::memory_order_release);
+                }
             }
-            else {
-                if (res.mana > cell.mana)
-                    replace_in_cell = true;
-                else if (res.mana == cell.mana && res.initial_blocks < cell.blocks)
-                    replace_in_cell = true;
+
+            // Split by other descriptors, don't touch it
+            if (foreignHeader(*shared)
+                || shared->descriptor_ids[0] != descriptor_ids[0] || shared->descriptor_ids[1] != descriptor_ids[1]) {
+                region.close();
+                return false;
             }
 
-            if (replace_in_cell) {
-                if (!cell.occupied)
-                    occupied_indices.push_back({ ix, iy });
+            store = shared;
+            local_store.reset();
+
+            // The front stays in this process, so it can't share a file with the others
+            front_path = "pareto_front_" + std::to_string(currentProcessId()) + ".txt";
 
-                cell.genome = gen;
-                cell.mana = res.mana;
-                cell.blocks = res.initial_blocks;
-                cell.usage_count = 0;
-                cell.occupied = true;
+            StoreLock lock(*this);
+            repairOccupied();
+            return true;
+        }
+
+        bool isShared() const { return local_store == nullptr; }
+
+        // Copy of a random elite that doesn't count as a use of its cell
+        bool peekElite(Genome& out_gen, std::mt19937& rng) {
+            StoreLock lock(*this);
+
+            if (store->occupied_count == 0)
+                return false;
+
+            int pos = store->occupied_indices[rng() % store->occupied_count];
+            out_gen = store->grid[pos / 20][pos % 20].genome;
+            return true;
+        }
+
+        void getGlobalBest(long& mana, int& blocks) {
+            StoreLock lock(*this);
+            mana = store->global_best_mana;
+            blocks = store->global_best_blocks;
+        }
+
+        // FNV-1a over the meaningful fields of every cell (padding skipped), to compare runs
+        uint64_t digest() {
+            StoreLock lock(*this);
+
+            uint64_t h = 1469598103934665603ull;
+            auto mix = [&](int64_t v) {
+                for (int i = 0; i < 8; ++i) {
+                    h ^= (uint64_t)(v >> (i * 8)) & 0xFF;
+                    h *= 1099511628211ull;
+                }
+                };
+
+            for (const auto& row : store->grid) {
+                for (const auto& cell : row) {
+                    mix(cell.occupied);
+                    if (!cell.occupied) continue;
+
+                    mix(cell.mana); mix(cell.blocks); mix(cell.usage_count);
+                    mix(cell.genome.symmetric); mix(cell.genome.organCount);
+                    for (int i = 0; i < cell.genome.organCount; ++i) {
+                        const Structure& s = cell.genome.organs[i];
+                        mix(s.x); mix(s.y); mix(s.isObstacle); mix(s.count);
+                        for (int j = 0; j < s.count; ++j) {
+                            mix(s.cells[j].dx); mix(s.cells[j].dy);
+                        }
+                    }
+                }
+            }
+            return h;
+        }
+
+        // Keeps a separate front in every MAP-Elites cell as well
+        void enableNicheFronts() {
+            std::lock_guard<std::mutex> lock(front_mtx);
+            niche_fronts.resize(400);
+        }
+
+        bool hasNicheFronts() {
+            std::lock_guard<std::mutex> lock(front_mtx);
+            return !niche_fronts.empty();
+        }
+
+        // ix * 20 + iy, same numbering as the niche fronts
+        static int nicheIndex(const SimulationResult& res) {
+            int ix, iy;
+            nicheOf(res, ix, iy);
+            return ix * 20 + iy;
+        }
+
+        // Offer any successful result, not only fitness improvements. pheno_x/y are needed for niche fronts,
+        // merged results (whose pheno_x/y are cut short) only go to the global one
+        bool submitPareto(const Genome& gen, const SimulationResult& res) {
+            std::lock_guard<std::mutex> lock(front_mtx);
+
+            if (!niche_fronts.empty() && !res.merged) {
+                int ix, iy;
+                nicheOf(res, ix, iy);
+                front_dirty |= niche_fronts[ix * 20 + iy].insert(gen, res);
+            }
+
+            if (!front.insert(gen, res))
+                return false;
+
+            front_dirty = true;
+            return true;
+        }
+
+        // Rewrites the front file (a full board per point) if anything changed. Called on a timer
+        // from the monitor thread, the workers never wait on it
+        void saveFront() {
+            std::vector<ParetoPoint> points;
+            std::vector<std::vector<ParetoPoint>> niches;
+            {
+                std::lock_guard<std::mutex> lock(front_mtx);
+                if (!front_dirty) return;
+                front_dirty = false;
+
+                points = front.points();
+                for (const auto& nf : niche_fronts)
+                    niches.push_back(nf.points());
+            }
+            writeFront(points, niches);
+        }
+
+        std::vector<ParetoPoint> getFront() {
+            std::lock_guard<std::mutex> lock(front_mtx);
+            return front.points();
+        }
+
+        void submit(const Genome& gen, const SimulationResult& res) {
+            int ix, iy;
+            nicheOf(res, ix, iy);
+
+            bool is_global_record = false;
+            {
+                StoreLock lock(*this);
+                ArchiveCell& cell = store->grid[ix][iy];
+
+                // Mana -> blocks. But now fitness-function search mana per blocks and this is not relevant
+                if (res.mana > store->global_best_mana) {
+                    store->global_best_mana = (int32_t)res.mana;
+                    store->global_best_blocks = res.initial_blocks;
+                    is_global_record = true;
+                }
+                else if (res.mana == store->global_best_mana && res.initial_blocks < store->global_best_blocks) {
+                    store->global_best_blocks = res.initial_blocks;
+                    is_global_record = true;
+                }
+
+                bool replace_in_cell = false;
+                if (!cell.occupied || cell.usage_count >= 3) {
+                    replace_in_cell = true;
+                }
+                else {
+                    if (res.mana > cell.mana)
+                        replace_in_cell = true;
+                    else if (res.mana == cell.mana && res.initial_blocks < cell.blocks)
+                        replace_in_cell = true;
+                }
+
+                if (replace_in_cell) {
+                    if (!cell.occupied)
+                        store->occupied_indices[store->occupied_count++] = (uint16_t)(ix * 20 + iy);
+
+                    cell.genome = gen;
+                    cell.mana = (int32_t)res.mana;
+                    cell.blocks = res.initial_blocks;
+                    cell.usage_count = 0;
+                    cell.occupied = true;
+                }
             }
 
+            // The file is written outside the lock, every process sharing it would wait on the disk
             if (is_global_record) {
                 saveToDisk(gen, res, ix, iy);
             }
         }
 
         bool getElite(Genome& out_gen, std::mt19937& rng) {
-            std::lock_guard<std::mutex> lock(archive_mtx);
+            StoreLock lock(*this);
 
-            if (occupied_indices.empty())
+            if (store->occupied_count == 0)
                 return false;
 
-            auto pos = occupied_indices[rng() % occupied_indices.size()];
-            auto& cell = grid[pos.first][pos.second];
+            int pos = store->occupied_indices[rng() % store->occupied_count];
+            auto& cell = store->grid[pos / 20][pos % 20];
 
-            for (int i = 0; i < 9; i++) {
+            for (int i = 0; i < MUTATION_TYPES; i++) {
                 out_gen.mutationWeights[i] = (out_gen.mutationWeights[i] + cell.genome.mutationWeights[i]) / 2.0;
             }
             
@@ -50,11 +50,49 @@ namespace Dandelifeon {
         double pheno_y = 0;
         
         bool success = false;
+        bool merged = false; // outcome taken over from another run: history and descriptors stop at the merge
         
         Bitboard history;
     };
 
+    // Scratch space of one behaviour descriptor during a run
+    struct DescriptorAcc {
+        double f[6];
+        int32_t i[4];
+    };
+
+    // Behaviour descriptor computed inside the run, the kernels live in Descriptors.hpp.
+    // start sees the start board, tick every new board (nullptr - no per-tick work), finish maps to 0..1.
+    // Start-board-only kernels are left out of the run, see Engine::startDescriptors
+    struct DescriptorKernel {
+        int id;           // stored in the shared archive
+        const char* name;
+        void (*start)(DescriptorAcc& acc, const Bitboard& board, const Bitboard& walls);
+        void (*tick)(DescriptorAcc& acc, const Bitboard& board, int t);
+        double (*finish)(const DescriptorAcc& acc, const SimulationResult& res, const Bitboard& walls, int max_ticks);
+    };
+
+    // Everything run() carries between ticks, so a simulation can be paused and resumed later
+    struct SimulationState {
+        Bitboard boards[2];
+        int cur = 0;
+        int tick = 0;
+        bool finished = false;
+
+        SimulationResult res;
+        DescriptorAcc desc[2]; // pheno_x, pheno_y
+
+        const Bitboard& board() const { return boards[cur]; }
+    };
+
     class Engine {
+    private:
+        const DescriptorKernel* descriptors[2] = { nullptr, nullptr };
+        bool tick_descriptors = false;
+        bool start_descriptors = false;
+
+        static bool startOnly(const DescriptorKernel* k) { return k && !k->tick; }
+
     public:
         int max_ticks; int mana_per_gen; long mana_cap;
         __m256i row_mask;
@@ -95,52 +133,108 @@ namespace Dandelifeon {
             }
         }
 
-        void getPhenotype(const Bitboard& b, double& x_out, double& y_out) const {
-            int total = 0; int x_min = 25, x_max = 0, y_min = 25, y_max = 0;
-            double sum_dist = 0; int count_structs = 0;
+        // Behaviour descriptors that end up in pheno_x / pheno_y, nullptr leaves it at 0
+        void setDescriptors(const DescriptorKernel* x, const DescriptorKernel* y) {
+            descriptors[0] = x;
+            descriptors[1] = y;
+            tick_descriptors = (x && x->tick) || (y && y->tick);
+            start_descriptors = startOnly(x) || startOnly(y);
+        }
+
+        // Writes pheno_x / pheno_y from what the run has seen so far. Start-board-only ones stay 0
+        void finishDescriptors(SimulationState& st, const Bitboard& obstacles) const {
+            st.res.pheno_x = descriptors[0] && descriptors[0]->tick ? descriptors[0]->finish(st.desc[0], st.res, obstacles, max_ticks) : 0;
+            st.res.pheno_y = descriptors[1] && descriptors[1]->tick ? descriptors[1]->finish(st.desc[1], st.res, obstacles, max_ticks) : 0;
+        }
+
+        // Start-board-only descriptors of a finished run. Most candidates are thrown away, so the
+        // run skips these and the caller fills them in from its own copy of the boards for the
+        // results it keeps
+        void startDescriptors(SimulationResult& res, const Bitboard& start_board, const Bitboard& obstacles) const {
+            if (!start_descriptors) return;
+
+            Bitboard board = start_board;
+            board.applyObstacles(obstacles);
+
+            for (int d = 0; d < 2; ++d) {
+                if (!startOnly(descriptors[d])) continue;
+
+                DescriptorAcc acc = DescriptorAcc();
+                descriptors[d]->start(acc, board, obstacles);
+                (d == 0 ? res.pheno_x : res.pheno_y) = descriptors[d]->finish(acc, res, obstacles, max_ticks);
+            }
+        }
+
+        // Chebyshev distance from the 3x3 center to the nearest live cell
+        static int distanceToCenter(const Bitboard& b) {
+            const uint32_t center_mask = (1 << 11) | (1 << 12) | (1 << 13);
+            int best = 99;
+
             for (int y = 1; y <= 25; ++y) {
                 uint32_t row = b.data[y];
-                if (row) {
-                    total += __popcnt(row);
-                    y_min = (std::min)(y_min, y); y_max = (std::max)(y_max, y);
-                    unsigned long first, last;
-                    _BitScanForward(&first, row); _BitScanReverse(&last, row);
-                    x_min = (std::min)(x_min, (int)first); x_max = (std::max)(x_max, (int)last);
-                    sum_dist += std::abs(y - 13);
-                    count_structs++;
+                if (!row) continue;
+
+                int dy = (std::max)(std::abs(y - 13) - 1, 0);
+                if (dy >= best) continue;
+
+                int dx = 99;
+                if (row & center_mask) {
+                    dx = 0;
                 }
+                else {
+                    unsigned long bit;
+                    uint32_t left = row & ((1u << 11) - 1);
+                    uint32_t right = row >> 14;
+                    if (left) { _BitScanReverse(&bit, left); dx = 11 - (int)bit; }
+                    if (right) { _BitScanForward(&bit, right); dx = (std::min)(dx, (int)bit + 1); }
+                }
+                best = (std::min)(best, (std::max)(dx, dy));
             }
-            if (total == 0) { 
-                x_out = 0; y_out = 0; 
-                return; 
-            }
-
-            x_out = (double)total / ((x_max - x_min + 1) * (y_max - y_min + 1));
-            y_out = sum_dist / count_structs;
+            return best;
         }
 
-        SimulationResult run(const Bitboard& start_board, const Bitboard& obstacles) const {
-            SimulationResult res;
-            res.history.clear();
+        void begin(const Bitboard& start_board, const Bitboard& obstacles, SimulationState& st) const {
+            st.res = SimulationResult();
+            st.res.history.clear();
 
+            st.cur = 0;
+            st.tick = 0;
+            st.finished = false;
+            st.boards[0] = start_board;
+            st.boards[0].applyObstacles(obstacles);
 
-            Bitboard curr_b = start_board;
-            curr_b.applyObstacles(obstacles);
+            st.res.initial_blocks = st.boards[0].popcount();
 
-            res.initial_blocks = curr_b.popcount();
+            for (int d = 0; d < 2; ++d) {
+                st.desc[d] = DescriptorAcc();
+                if (descriptors[d] && descriptors[d]->tick) descriptors[d]->start(st.desc[d], st.boards[0], obstacles);
+            }
+        }
 
-            Bitboard buffer;
-            Bitboard* curr = &curr_b, * nxt = &buffer;
+        // Simulates up to tick `until` (never past max_ticks). Returns true once the run is over
+        bool advance(SimulationState& st, const Bitboard& obstacles, int until) const {
+            if (st.finished) return true;
+
+            SimulationResult& res = st.res;
+            Bitboard* curr = &st.boards[st.cur], * nxt = &st.boards[st.cur ^ 1];
 
             uint32_t center_mask = (1 << 11) | (1 << 12) | (1 << 13);
-            double best_proximity = 0;
+            int last = (std::min)(until, max_ticks);
 
-            for (int t = 1; t <= max_ticks; ++t) {
+            for (int t = st.tick + 1; t <= last; ++t) {
                 // Footprint for living cells
                 res.history.merge(*curr);
 
                 nxt->clear();
                 step_avx2(*curr, *nxt, obstacles);
+                st.tick = t;
+                st.cur ^= 1;
+
+                // Descriptors ride along on the board that is still hot in cache
+                if (tick_descriptors) {
+                    for (int d = 0; d < 2; ++d)
+                        if (descriptors[d] && descriptors[d]->tick) descriptors[d]->tick(st.desc[d], *nxt, t);
+                }
 
                 uint32_t hits = ((*nxt)[12] | (*nxt)[13] | (*nxt)[14]) & center_mask;
                 if (hits) {
@@ -154,23 +248,29 @@ namespace Dandelifeon {
                     double blocks = (res.initial_blocks > 0) ? (double)res.initial_blocks : 1.0;
                     res.fitness = (double)res.mana / blocks;
 
-                    return res;
-                }
-
-                // Wall can help achive center but dont count on it
-                for (int y = 1; y <= 25; ++y) {
-                    if ((*nxt)[y]) {
-                        double dist_score = 25.0 - std::abs(y - 13);
-                        best_proximity = (std::max)(best_proximity, dist_score + (t * 0.1));
-                    }
+                    st.finished = true;
+                    finishDescriptors(st, obstacles);
+                    return true;
                 }
 
                 std::swap(curr, nxt);
                 if (curr->isEmpty()) break;
             }
 
-            res.fitness = 0;
-            return res;
+            if (st.tick >= max_ticks || st.board().isEmpty()) {
+                res.fitness = 0;
+                st.finished = true;
+                finishDescriptors(st, obstacles);
+            }
+            return st.finished;
+        }
+
+        SimulationResult run(const Bitboard& start_board, const Bitboard& obstacles) const {
+            SimulationState st;
+            begin(start_board, obstacles, st);
+            advance(st, obstacles, max_ticks);
+            startDescriptors(st.res, start_board, obstacles);
+            return st.res;
         }
     };
 }
\ No newline at end of file
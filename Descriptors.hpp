@@ -0,0 +1,354 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <immintrin.h>
+#include <intrin.h>
+
+#include "DandelifeonEngine.hpp"
+
+
+namespace Dandelifeon {
+    // Behaviour descriptors for the MAP-Elites axes. "density" and "row_spread" are the original
+    // phenotype and only look at the start board, so only kept results pay for them
+    // (Engine::startDescriptors); the rest follow the run tick by tick inside Engine::advance,
+    // so nothing is rasterized or simulated a second time.
+    // Every value is mapped to 0..1, the archive splits that into 20 niches
+    class Descriptors {
+    private:
+        static constexpr int CX = 12, CY = 13; // center cell: bit 12 of row 13
+
+        struct Moments {
+            int count = 0;
+            int sum_x = 0;
+            int sum_y = 0;
+        };
+
+        // Per 32-bit lane popcount: nibble lookup, then bytes -> lanes
+        static __m256i popcount32(__m256i v) {
+            const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            const __m256i low = _mm256_set1_epi8(0x0F);
+
+            __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, low));
+            __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi32(v, 4), low));
+            __m256i bytes = _mm256_add_epi8(lo, hi);
+            __m256i words = _mm256_maddubs_epi16(bytes, _mm256_set1_epi8(1));
+            return _mm256_madd_epi16(words, _mm256_set1_epi16(1));
+        }
+
+        static int hsum(__m256i v) {
+            __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+            return _mm_cvtsi128_si32(s);
+        }
+
+        // Columns whose index has bit k set, so sum of x = sum of 2^k * popcount(row & X_BIT[k])
+        static constexpr uint32_t xBitMask(int k) {
+            uint32_t m = 0;
+            for (int x = 0; x < 25; ++x) if ((x >> k) & 1) m |= 1u << x;
+            return m;
+        }
+
+        // Cell count and coordinate sums of rows y_lo..y_hi, columns in `cols`, split at row `split`
+        // (rows above it go to `above`, below it to `below`, the row itself is skipped). 8 rows per pass,
+        // lanes outside the row range are masked (rows past 25 hold the engine's overflow)
+        template<bool Sums>
+        static void moments(const Bitboard& b, int y_lo, int y_hi, uint32_t cols, int split, Moments& above, Moments& below) {
+            static constexpr uint32_t X_BIT[5] = { xBitMask(0), xBitMask(1), xBitMask(2), xBitMask(3), xBitMask(4) };
+
+            __m256i count[2] = {}, sum_x[2] = {}, sum_y[2] = {};
+            __m256i col_mask = _mm256_set1_epi32((int)cols);
+            __m256i lo = _mm256_set1_epi32(y_lo - 1), hi = _mm256_set1_epi32(y_hi + 1), mid = _mm256_set1_epi32(split);
+
+            for (int i = 1; i <= 25; i += 8) {
+                __m256i y = _mm256_add_epi32(_mm256_set1_epi32(i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+                __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi32(y, lo), _mm256_cmpgt_epi32(hi, y));
+
+                __m256i row = _mm256_loadu_si256((const __m256i*) & b.data[i]);
+                row = _mm256_and_si256(_mm256_and_si256(row, col_mask), in_range);
+
+                __m256i pc = popcount32(row);
+                __m256i sx = _mm256_setzero_si256();
+                if constexpr (Sums) {
+                    for (int k = 0; k < 5; ++k)
+                        sx = _mm256_add_epi32(sx, _mm256_slli_epi32(popcount32(_mm256_and_si256(row, _mm256_set1_epi32((int)X_BIT[k]))), k));
+                }
+
+                __m256i side[2] = { _mm256_cmpgt_epi32(mid, y), _mm256_cmpgt_epi32(y, mid) };
+                for (int h = 0; h < 2; ++h) {
+                    count[h] = _mm256_add_epi32(count[h], _mm256_and_si256(pc, side[h]));
+                    if constexpr (Sums) {
+                        sum_x[h] = _mm256_add_epi32(sum_x[h], _mm256_and_si256(sx, side[h]));
+                        sum_y[h] = _mm256_add_epi32(sum_y[h], _mm256_and_si256(_mm256_mullo_epi32(pc, y), side[h]));
+                    }
+                }
+            }
+
+            Moments* out[2] = { &above, &below };
+            for (int h = 0; h < 2; ++h) {
+                out[h]->count = hsum(count[h]);
+                out[h]->sum_x = Sums ? hsum(sum_x[h]) : 0;
+                out[h]->sum_y = Sums ? hsum(sum_y[h]) : 0;
+            }
+        }
+
+        static int population(const Bitboard& b, int y_lo, int y_hi, uint32_t cols) {
+            Moments above, below;
+            moments<false>(b, y_lo, y_hi, cols, 99, above, below);
+            return above.count;
+        }
+
+        static constexpr uint32_t BOARD_COLS = 0x1FFFFFF;
+        // 11x11 around the center: the last few ticks of an approach happen in here
+        static constexpr uint32_t NEAR_COLS = ((1u << 11) - 1) << (CX - 5);
+        static constexpr int NEAR_LO = CY - 5, NEAR_HI = CY + 5;
+
+        // ---- density / row_spread: the original phenotype, on the start board ----
+        // They run for every candidate, so one pass over the rows gives all they need
+
+        struct Outline {
+            int total = 0;
+            uint32_t cols = 0; // OR of all rows
+            uint32_t rows = 0; // bit y - 1 set when row y has cells
+        };
+
+        static Outline outline(const Bitboard& b) {
+            __m256i any = _mm256_setzero_si256(), count = _mm256_setzero_si256();
+            Outline o;
+
+            for (int i = 1; i <= 25; i += 8) {
+                __m256i row = _mm256_loadu_si256((const __m256i*) & b.data[i]);
+                if (i == 25) row = _mm256_and_si256(row, _mm256_setr_epi32(-1, 0, 0, 0, 0, 0, 0, 0));
+
+                any = _mm256_or_si256(any, row);
+                count = _mm256_add_epi32(count, popcount32(row));
+
+                uint32_t empty = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(row, _mm256_setzero_si256())));
+                o.rows |= (~empty & 0xFF) << (i - 1);
+            }
+
+            __m128i c = _mm_or_si128(_mm256_castsi256_si128(any), _mm256_extracti128_si256(any, 1));
+            c = _mm_or_si128(c, _mm_shuffle_epi32(c, 0x4E));
+            c = _mm_or_si128(c, _mm_shuffle_epi32(c, 0xB1));
+            o.cols = (uint32_t)_mm_cvtsi128_si32(c);
+            o.total = hsum(count);
+            return o;
+        }
+
+        static void densityStart(DescriptorAcc& acc, const Bitboard& b, const Bitboard&) {
+            Outline o = outline(b);
+            if (o.total == 0) { acc.f[0] = 0; return; }
+
+            unsigned long x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+            _BitScanForward(&x_min, o.cols); _BitScanReverse(&x_max, o.cols);
+            _BitScanForward(&y_min, o.rows); _BitScanReverse(&y_max, o.rows);
+            acc.f[0] = (double)o.total / ((x_max - x_min + 1) * (y_max - y_min + 1));
+        }
+
+        // Rows whose |y - 13| has bit k set
+        static constexpr uint32_t rowDistMask(int k) {
+            uint32_t m = 0;
+            for (int y = 1; y <= 25; ++y) if ((((y > CY) ? y - CY : CY - y) >> k) & 1) m |= 1u << (y - 1);
+            return m;
+        }
+
+        // Average |y - 13| over non-empty rows, 18 rows of distance is the old upper end
+        static void rowSpreadStart(DescriptorAcc& acc, const Bitboard& b, const Bitboard&) {
+            static constexpr uint32_t DIST_BIT[4] = { rowDistMask(0), rowDistMask(1), rowDistMask(2), rowDistMask(3) };
+
+            uint32_t rows = outline(b).rows;
+            if (!rows) { acc.f[0] = 0; return; }
+
+            int sum_dist = 0;
+            for (int k = 0; k < 4; ++k) sum_dist += (int)__popcnt(rows & DIST_BIT[k]) << k;
+            acc.f[0] = (double)sum_dist / __popcnt(rows) / 18.0;
+        }
+
+        static double startValue(const DescriptorAcc& acc, const SimulationResult&, const Bitboard&, int) {
+            return acc.f[0];
+        }
+
+        // ---- centroid_path: how far the top and bottom halves travel ----
+        // Whole-board centroid of a symmetric genome never leaves the center, the halves do
+
+        static void halfCentroids(const Bitboard& b, double c[4], bool has[2]) {
+            Moments top, bottom;
+            moments<true>(b, 1, 25, BOARD_COLS, CY, top, bottom);
+            has[0] = top.count > 0;
+            has[1] = bottom.count > 0;
+            if (has[0]) { c[0] = (double)top.sum_x / top.count; c[1] = (double)top.sum_y / top.count; }
+            if (has[1]) { c[2] = (double)bottom.sum_x / bottom.count; c[3] = (double)bottom.sum_y / bottom.count; }
+        }
+
+        static void centroidPathStart(DescriptorAcc& acc, const Bitboard& b, const Bitboard&) {
+            bool has[2];
+            halfCentroids(b, acc.f, has);
+            acc.i[0] = has[0];
+            acc.i[1] = has[1];
+        }
+
+        static void centroidPathTick(DescriptorAcc& acc, const Bitboard& b, int) {
+            double c[4];
+            bool has[2];
+            halfCentroids(b, c, has);
+
+            for (int h = 0; h < 2; ++h) {
+                if (!has[h]) continue;
+                if (acc.i[h]) acc.f[4] += std::hypot(c[2 * h] - acc.f[2 * h], c[2 * h + 1] - acc.f[2 * h + 1]);
+                acc.f[2 * h] = c[2 * h];
+                acc.f[2 * h + 1] = c[2 * h + 1];
+                acc.i[h] = 1;
+            }
+        }
+
+        // A glider makes ~0.35 cells per tick, so 0..1 covers everything up to two fast halves
+        static double centroidPathFinish(const DescriptorAcc& acc, const SimulationResult&, const Bitboard&, int) {
+            return acc.f[4] / 2.0 / 48.0;
+        }
+
+        // ---- approach_angle: do the cells near the center come from the sides or from top/bottom ----
+        // Share of cells in the 11x11 window that lie in the left/right sectors (|dx| > |dy|),
+        // taken on the last tick before the run ended. 0.5 when the window was never reached
+
+        static uint32_t sideCols(int y) {
+            uint32_t m = 0;
+            for (int x = 0; x < 25; ++x)
+                if (std::abs(x - CX) > std::abs(y - CY)) m |= 1u << x;
+            return m;
+        }
+
+        static double sideShare(const Bitboard& b) {
+            static const std::vector<uint32_t> side = [] {
+                std::vector<uint32_t> s(34, 0);
+                for (int y = NEAR_LO; y <= NEAR_HI; ++y) s[y] = sideCols(y) & NEAR_COLS;
+                return s;
+            }();
+
+            __m256i all = _mm256_setzero_si256(), sides = _mm256_setzero_si256();
+            __m256i near_cols = _mm256_set1_epi32((int)NEAR_COLS);
+
+            // Window rows 8..18 are two loads
+            for (int i = NEAR_LO; i <= NEAR_HI; i += 8) {
+                __m256i row = _mm256_loadu_si256((const __m256i*) & b.data[i]);
+                __m256i s = _mm256_loadu_si256((const __m256i*) & side[i]);
+
+                __m256i near = _mm256_and_si256(row, near_cols);
+                if (i + 7 > NEAR_HI) {
+                    __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+                    near = _mm256_and_si256(near, _mm256_cmpgt_epi32(_mm256_set1_epi32(NEAR_HI - i + 1), lane));
+                }
+
+                all = _mm256_add_epi32(all, popcount32(near));
+                sides = _mm256_add_epi32(sides, popcount32(_mm256_and_si256(near, s)));
+            }
+
+            int n = hsum(all);
+            return n ? (double)hsum(sides) / n : -1.0;
+        }
+
+        static void approachStart(DescriptorAcc& acc, const Bitboard& b, const Bitboard&) {
+            acc.f[0] = sideShare(b);
+            acc.f[1] = -1.0;
+        }
+
+        static void approachTick(DescriptorAcc& acc, const Bitboard& b, int) {
+            double s = sideShare(b);
+            if (s < 0) return;
+            acc.f[1] = acc.f[0];
+            acc.f[0] = s;
+        }
+
+        // On a hit the last board already sits on the center, the one before shows the approach
+        static double approachFinish(const DescriptorAcc& acc, const SimulationResult& res, const Bitboard&, int) {
+            double s = (res.success && acc.f[1] >= 0) ? acc.f[1] : acc.f[0];
+            return s >= 0 ? s : 0.5;
+        }
+
+        // ---- peak_population ----
+
+        static void peakStart(DescriptorAcc& acc, const Bitboard& b, const Bitboard&) {
+            acc.i[0] = population(b, 1, 25, BOARD_COLS);
+        }
+
+        static void peakTick(DescriptorAcc& acc, const Bitboard& b, int) {
+            acc.i[0] = (std::max)(acc.i[0], population(b, 1, 25, BOARD_COLS));
+        }
+
+        static double peakFinish(const DescriptorAcc& acc, const SimulationResult&, const Bitboard&, int) {
+            return acc.i[0] / 128.0;
+        }
+
+        // ---- closest_approach: tick with the most cells in the 11x11 window around the center ----
+
+        static void closestStart(DescriptorAcc& acc, const Bitboard& b, const Bitboard&) {
+            acc.i[0] = population(b, NEAR_LO, NEAR_HI, NEAR_COLS);
+            acc.i[1] = 0;
+        }
+
+        static void closestTick(DescriptorAcc& acc, const Bitboard& b, int t) {
+            int n = population(b, NEAR_LO, NEAR_HI, NEAR_COLS);
+            if (n > acc.i[0]) {
+                acc.i[0] = n;
+                acc.i[1] = t;
+            }
+        }
+
+        static double closestFinish(const DescriptorAcc& acc, const SimulationResult&, const Bitboard&, int max_ticks) {
+            return max_ticks > 0 ? (double)acc.i[1] / max_ticks : 0;
+        }
+
+        // ---- wall_utilization: share of walls that ever had life next to them ----
+        // history is the engine's footprint of every board but the last one, so no per-tick work
+
+        static void wallStart(DescriptorAcc& acc, const Bitboard&, const Bitboard& walls) {
+            acc.i[0] = walls.popcount();
+        }
+
+        static double wallFinish(const DescriptorAcc& acc, const SimulationResult& res, const Bitboard& walls, int) {
+            if (acc.i[0] == 0) return 0;
+
+            const Bitboard& h = res.history;
+            __m256i touched = _mm256_setzero_si256();
+            for (int i = 1; i <= 25; i += 8) {
+                __m256i mid = _mm256_loadu_si256((const __m256i*) & h.data[i]);
+                __m256i top = _mm256_loadu_si256((const __m256i*) & h.data[i - 1]);
+                __m256i bot = _mm256_loadu_si256((const __m256i*) & h.data[i + 1]);
+
+                __m256i rows = _mm256_or_si256(_mm256_or_si256(top, mid), bot);
+                __m256i near = _mm256_or_si256(rows, _mm256_or_si256(_mm256_slli_epi32(rows, 1), _mm256_srli_epi32(rows, 1)));
+
+                __m256i w = _mm256_loadu_si256((const __m256i*) & walls.data[i]);
+                __m256i hit = _mm256_and_si256(near, w);
+                if (i == 25) hit = _mm256_and_si256(hit, _mm256_setr_epi32(-1, 0, 0, 0, 0, 0, 0, 0));
+
+                touched = _mm256_add_epi32(touched, popcount32(hit));
+            }
+            return (double)hsum(touched) / acc.i[0];
+        }
+
+    public:
+        // Ids are stored in shared archives: append new kernels, never renumber
+        static const std::vector<DescriptorKernel>& all() {
+            static const std::vector<DescriptorKernel> kernels = {
+                { 0, "density",          densityStart,      nullptr,          startValue },
+                { 1, "row_spread",       rowSpreadStart,    nullptr,          startValue },
+                { 2, "centroid_path",    centroidPathStart, centroidPathTick, centroidPathFinish },
+                { 3, "approach_angle",   approachStart,     approachTick,     approachFinish },
+                { 4, "peak_population",  peakStart,         peakTick,         peakFinish },
+                { 5, "closest_approach", closestStart,      closestTick,      closestFinish },
+                { 6, "wall_utilization", wallStart,         nullptr,          wallFinish },
+            };
+            return kernels;
+        }
+
+        static const DescriptorKernel* find(const std::string& name) {
+            for (const auto& k : all())
+                if (name == k.name) return &k;
+            return nullptr;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include "Archive.hpp"
+#include "Worker.hpp"
+
+
+namespace Dandelifeon {
+    struct RunConfig {
+        uint32_t seed = 1;
+        int threads = 7;
+        uint64_t max_iters = 0;   // total over all workers, 0 - no limit
+        double max_seconds = 0;   // 0 - no limit
+        uint64_t epoch = 10'000;  // iterations per worker between archive barriers
+        std::string json_path;    // empty - stdout
+    };
+
+    class EpochBarrier {
+    private:
+        std::mutex mtx;
+        std::condition_variable cv;
+        int count;
+        int waiting = 0;
+        uint64_t generation = 0;
+
+    public:
+        explicit EpochBarrier(int n) : count(n) {}
+
+        // The last thread to arrive runs `completion` alone, then everyone is released
+        template<class F>
+        void arriveAndWait(F&& completion) {
+            std::unique_lock<std::mutex> lock(mtx);
+            uint64_t gen = generation;
+
+            if (++waiting == count) {
+                completion();
+                waiting = 0;
+                generation++;
+                cv.notify_all();
+                return;
+            }
+            cv.wait(lock, [&] { return generation != gen; });
+        }
+    };
+
+    // Headless run for benchmarking. Workers only meet the archive at epoch barriers, where
+    // they flush in id order, so with the same seed, thread count and iteration budget every run
+    // ends with the same archive (see archive_digest). A time budget is checked at the barriers,
+    // which makes the stopping point - and only that - depend on the machine
+    inline int runDeterministic(Archive& archive, const Engine& engine, RunConfig cfg) {
+        struct Improvement {
+            uint64_t iteration;
+            int worker;
+            uint64_t worker_iteration;
+            long mana;
+            int blocks;
+            double flush_seconds; // when the barrier that flushed it ran, not when it was found
+        };
+        struct Submitted {
+            uint64_t worker_iteration;
+            int worker;
+            long mana;
+            int blocks;
+        };
+
+        if (cfg.max_iters == 0 && cfg.max_seconds <= 0)
+            cfg.max_iters = 10'000'000;
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (int i = 0; i < cfg.threads; ++i)
+            workers.push_back(std::make_unique<Worker>(i, archive, engine, cfg.seed + i, true));
+
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = [&] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+        EpochBarrier barrier(cfg.threads);
+        uint64_t epochs = 0;
+        bool stop = false;
+
+        long best_mana = 0;
+        int best_blocks = 999;
+        std::vector<Improvement> improvements;
+        std::vector<Submitted> submitted;
+
+        auto onSubmit = [&](int id, uint64_t worker_iter, const SimulationResult& res) {
+            submitted.push_back({ worker_iter, id, res.mana, res.initial_blocks });
+            };
+
+        auto endOfEpoch = [&] {
+            submitted.clear();
+            for (auto& w : workers)
+                w->flush(onSubmit);
+
+            // Flushes go worker by worker; improvements are judged in the order they were found
+            std::sort(submitted.begin(), submitted.end(), [](const Submitted& a, const Submitted& b) {
+                if (a.worker_iteration != b.worker_iteration) return a.worker_iteration < b.worker_iteration;
+                return a.worker < b.worker;
+                });
+
+            double now = elapsed();
+            for (const auto& s : submitted) {
+                if (s.mana > best_mana || (s.mana == best_mana && s.blocks < best_blocks)) {
+                    best_mana = s.mana;
+                    best_blocks = s.blocks;
+                    // Workers move in lockstep, so this is the total iteration count when it was found
+                    improvements.push_back({ s.worker_iteration * cfg.threads, s.worker, s.worker_iteration, s.mana, s.blocks, now });
+                }
+            }
+
+            epochs++;
+            uint64_t total = epochs * cfg.epoch * cfg.threads;
+            if (cfg.max_iters > 0 && total >= cfg.max_iters) stop = true;
+            if (cfg.max_seconds > 0 && elapsed() >= cfg.max_seconds) stop = true;
+            };
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < cfg.threads; ++i) {
+            threads.emplace_back([&, i] {
+                while (true) {
+                    for (uint64_t k = 0; k < cfg.epoch; ++k)
+                        workers[i]->step();
+
+                    barrier.arriveAndWait(endOfEpoch);
+                    if (stop) break;
+                }
+                });
+        }
+        for (auto& t : threads) t.join();
+        archive.saveFront();
+
+        double seconds = elapsed();
+        uint64_t total = epochs * cfg.epoch * cfg.threads;
+
+        std::ostringstream js;
+        js << std::fixed << std::setprecision(3);
+        js << "{\n";
+        js << "  \"seed\": " << cfg.seed << ",\n";
+        js << "  \"threads\": " << cfg.threads << ",\n";
+        js << "  \"epoch\": " << cfg.epoch << ",\n";
+        js << "  \"iterations\": " << total << ",\n";
+        js << "  \"seconds\": " << seconds << ",\n";
+        // Merged candidates never run to the end, so this isn't a simulation rate
+        js << "  \"candidates_per_sec\": " << (seconds > 0 ? total / seconds : 0.0) << ",\n";
+        js << "  \"best_mana\": " << best_mana << ",\n";
+        js << "  \"best_blocks\": " << (best_mana > 0 ? best_blocks : 0) << ",\n";
+        js << "  \"pareto_points\": " << archive.getFront().size() << ",\n";
+        js << "  \"archive_digest\": \"" << std::hex << archive.digest() << std::dec << "\",\n";
+        js << "  \"improvements\": [";
+        for (size_t i = 0; i < improvements.size(); ++i) {
+            const auto& imp = improvements[i];
+            js << (i ? ",\n" : "\n") << "    { \"iteration\": " << imp.iteration
+                << ", \"worker\": " << imp.worker
+                << ", \"worker_iteration\": " << imp.worker_iteration
+                << ", \"mana\": " << imp.mana
+                << ", \"blocks\": " << imp.blocks
+                << ", \"flush_seconds\": " << imp.flush_seconds << " }";
+        }
+        js << (improvements.empty() ? "]\n" : "\n  ]\n");
+        js << "}\n";
+
+        if (cfg.json_path.empty()) {
+            std::cout << js.str();
+        }
+        else {
+            std::ofstream f(cfg.json_path);
+            if (!f.is_open()) return 1;
+            f << js.str();
+        }
+        return 0;
+    }
+}
\ No newline at end of file
@@ -3,11 +3,13 @@
 #include <vector>
 
 #include "Genome.hpp"
+#include "PatternLibrary.hpp"
 
 namespace Dandelifeon {
     class EvolutionManager {
     public:
-        static void mutate(Genome& gen, std::mt19937& rng, const Bitboard& footprint) {
+        // target_tick: when the parent hits the center, aimed movers are timed to arrive no earlier
+        static void mutate(Genome& gen, std::mt19937& rng, const Bitboard& footprint, int target_tick = 0) {
 
             if (gen.organCount == 0 || countLifeOrgans(gen) == 0) {
                 forceAddLife(gen, rng);
@@ -144,6 +146,27 @@ namespace Dandelifeon {
             }
             break;
 
+            case 9: // Aimed mover
+            {
+                if (gen.organCount >= 15) break;
+
+                const auto& stamps = PatternLibrary::get().all();
+                const MoverStamp& st = stamps[rng() % stamps.size()];
+
+                // Put it on its own trajectory, hitting no earlier than the parent did
+                int periods = PatternLibrary::choosePeriods(st, target_tick, rng);
+                int x, y;
+                PatternLibrary::aimAtCenter(st, periods, x, y);
+
+                Structure mover = st.shape;
+                mover.x = (int8_t)x;
+                mover.y = (int8_t)y;
+                mover.isObstacle = false;
+
+                gen.organs[gen.organCount++] = mover;
+            }
+            break;
+
             }
 
             if (countLifeOrgans(gen) == 0) forceAddLife(gen, rng);
@@ -8,19 +8,22 @@
 
 
 namespace Dandelifeon {
+    constexpr int MUTATION_TYPES = 10;
+
     struct Genome {
         Structure organs[15];
         int8_t organCount = 0;
 
         bool symmetric = false;
 
-        std::array<double, 9> mutationWeights;
+        std::array<double, MUTATION_TYPES> mutationWeights;
         int lastMutationType = -1;
 
         Genome() {
-            mutationWeights.fill(1.0 / 9.0);
+            mutationWeights.fill(1.0 / MUTATION_TYPES);
             // Add "smart" wall is way more valuable
             mutationWeights[8] = 0.4;
+            normalizeWeights();
             organCount = 0;
             symmetric = true;
         }
@@ -29,20 +32,15 @@ namespace Dandelifeon {
             std::uniform_real_distribution<double> dist(0.0, 1.0);
             double r = dist(rng);
             double cumulative = 0;
-            for (int i = 0; i < 9; ++i) {
+            for (int i = 0; i < MUTATION_TYPES; ++i) {
                 cumulative += mutationWeights[i];
                 if (r <= cumulative)  return i;
             }
 
-            return 8;
+            return MUTATION_TYPES - 1;
         }
 
-        void rewardLastMutation() {
-            if (lastMutationType == -1) 
-                return;
-
-            double boost = 0.05;
-            mutationWeights[lastMutationType] += boost;
+        void normalizeWeights() {
             double sum = 0;
 
             for (double w : mutationWeights) 
@@ -52,6 +50,15 @@ namespace Dandelifeon {
                 w /= sum;
         }
 
+        void rewardLastMutation() {
+            if (lastMutationType == -1) 
+                return;
+
+            double boost = 0.05;
+            mutationWeights[lastMutationType] += boost;
+            normalizeWeights();
+        }
+
         void drawOrgan(const Structure& org, Bitboard& b) const {
             for (int j = 0; j < org.count; ++j) {
                 int realX = org.x + org.cells[j].dx;
@@ -6,11 +6,15 @@
 #include <sstream>
 #include <chrono>
 
+#include "ParetoFront.hpp"
+#include "PreScreen.hpp"
+
 
 namespace Dandelifeon {
     class Leaderboard {
     private:
         int num_threads;
+        bool reverse; // reverse search running, show its count
         long global_max_mana = 0;
         int global_min_blocks = 999;
         std::mutex leaderboard_mtx;
@@ -19,7 +23,7 @@ namespace Dandelifeon {
         double current_speed = 0;
 
     public:
-        Leaderboard(int n) : num_threads(n) {
+        Leaderboard(int n, bool reverse_search = false) : num_threads(n), reverse(reverse_search) {
             last_time = std::chrono::steady_clock::now();
         }
 
@@ -36,7 +40,10 @@ namespace Dandelifeon {
 
         void draw(const std::vector<long>& thread_mana,
             const std::vector<int>& thread_blocks,
-            uint64_t total_iters) {
+            uint64_t total_iters,
+            const std::vector<ParetoPoint>& front,
+            const PreScreenStats& screen,
+            uint64_t reverse_found = 0) {
 
             // (M iters per s)
             auto now = std::chrono::steady_clock::now();
@@ -82,6 +89,27 @@ namespace Dandelifeon {
                     << global_min_blocks << " blocks\n";
             }
 
+            ss << "PARETO FRONT:  " << front.size() << " points (mana | blocks | ticks)\n";
+            int front_limit = (front.size() > 10) ? 10 : (int)front.size();
+            for (int i = 0; i < front_limit; ++i) {
+                ss << "  " << std::left << std::setw(8) << front[i].mana
+                    << std::setw(8) << front[i].blocks << front[i].ticks << "      \n";
+            }
+
+            if (reverse)
+                ss << "REVERSE SEARCH: " << reverse_found << " verified predecessors\n";
+
+            if (screen.enabled && total_iters > 0) {
+                ss << "PRE-SCREEN:     " << std::fixed << std::setprecision(1)
+                    << 100.0 * screen.merges / total_iters << "% merged into the parent's run      \n";
+            }
+            if (screen.enabled && screen.learned) {
+                ss << "LEARNED:        " << screen.learned_rejects << " dropped | " << screen.audits << " audits, "
+                    << screen.audit_misses << " missed | slack " << screen.slack << "      \n";
+            }
+
+            ss << "-------------------------------------------\n";
+
             ss << "TOTAL PROGRESS: " << std::fixed << std::setprecision(2) << (total_iters / 1000000.0) << " M simulation\n";
             ss << "CURRENT SPEED:  " << std::fixed << std::setprecision(2) << current_speed << " M simulation/s\n";
 
@@ -0,0 +1,86 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include "Genome.hpp"
+#include "DandelifeonEngine.hpp"
+
+
+namespace Dandelifeon {
+    struct ParetoPoint {
+        Genome genome;
+        long mana = 0;
+        int blocks = 0;
+        int ticks = 0;
+    };
+
+    // Non-dominated set over (mana max, blocks min, ticks min).
+    // Every tick count keeps its own staircase blocks -> point where mana strictly grows with blocks,
+    // so checking one layer is a single map lookup. Ticks are bounded by Engine::max_ticks,
+    // which keeps the number of layers small
+    class ParetoFront {
+    private:
+        std::map<int, std::map<int, ParetoPoint>> layers; // ticks -> blocks -> point
+        size_t count = 0;
+
+    public:
+        // Equal point counts as dominated, the front never holds duplicates
+        bool dominated(long mana, int blocks, int ticks) const {
+            for (auto layer = layers.begin(); layer != layers.end() && layer->first <= ticks; ++layer) {
+                auto it = layer->second.upper_bound(blocks);
+                if (it == layer->second.begin()) continue;
+
+                // Largest blocks <= ours has the best mana of this layer
+                if ((--it)->second.mana >= mana) return true;
+            }
+            return false;
+        }
+
+        bool insert(const Genome& gen, const SimulationResult& res) {
+            if (!res.success || dominated(res.mana, res.initial_blocks, res.ticks))
+                return false;
+
+            for (auto layer = layers.lower_bound(res.ticks); layer != layers.end();) {
+                auto& stairs = layer->second;
+                auto it = stairs.lower_bound(res.initial_blocks);
+
+                // Dominated points are a run starting at our block count
+                while (it != stairs.end() && it->second.mana <= res.mana) {
+                    it = stairs.erase(it);
+                    count--;
+                }
+
+                if (stairs.empty()) layer = layers.erase(layer);
+                else ++layer;
+            }
+
+            ParetoPoint& p = layers[res.ticks][res.initial_blocks];
+            p.genome = gen;
+            p.mana = res.mana;
+            p.blocks = res.initial_blocks;
+            p.ticks = res.ticks;
+            count++;
+            return true;
+        }
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        // Best mana first
+        std::vector<ParetoPoint> points() const {
+            std::vector<ParetoPoint> out;
+            out.reserve(count);
+            for (const auto& layer : layers)
+                for (const auto& p : layer.second)
+                    out.push_back(p.second);
+
+            std::sort(out.begin(), out.end(), [](const ParetoPoint& a, const ParetoPoint& b) {
+                if (a.mana != b.mana) return a.mana > b.mana;
+                if (a.blocks != b.blocks) return a.blocks < b.blocks;
+                return a.ticks < b.ticks;
+                });
+            return out;
+        }
+    };
+}
\ No newline at end of file
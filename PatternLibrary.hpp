@@ -0,0 +1,153 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "Structure.hpp"
+
+
+namespace Dandelifeon {
+    // Known spaceship: base phase, period and displacement per period (y grows downwards)
+    struct MoverPattern {
+        int period;
+        int vx, vy;
+        int count;
+        RelativePoint cells[10];
+    };
+
+    // One ready-to-paste stamp: orientation + phase of some mover
+    struct MoverStamp {
+        Structure shape;
+        int period;
+        int vx, vy;
+        int phase; // after (period - phase) ticks it is the base phase again, shifted by (vx, vy)
+        int lead;  // how many ticks earlier than the anchor its front edge touches the 3x3 center
+    };
+
+    // Everything must fit into one Structure (10 cells), so MWSS/HWSS and puffers are out
+    inline const MoverPattern MOVER_PATTERNS[] = {
+        { 4, 1, 1, 5, { {0, -1}, {1, 0}, {-1, 1}, {0, 1}, {1, 1} } },
+        { 4, -2, 0, 9, { {-1, -2}, {2, -2}, {-2, -1}, {-2, 0}, {2, 0}, {-2, 1}, {-1, 1}, {0, 1}, {1, 1} } },
+    };
+
+    class PatternLibrary {
+    private:
+        std::vector<MoverStamp> stamps;
+
+        using Cells = std::vector<RelativePoint>;
+
+        // Plain Life step on a handful of points, only used while building the library
+        static Cells lifeStep(const Cells& cells) {
+            constexpr int R = 16, W = 2 * R + 1;
+            uint8_t alive[W][W] = {};
+            uint8_t count[W][W] = {};
+
+            for (auto p : cells) alive[p.dy + R][p.dx + R] = 1;
+            for (auto p : cells)
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                        if (dx || dy) count[p.dy + R + dy][p.dx + R + dx]++;
+
+            Cells out;
+            for (int y = 0; y < W; ++y)
+                for (int x = 0; x < W; ++x)
+                    if (count[y][x] == 3 || (count[y][x] == 2 && alive[y][x]))
+                        out.push_back({ (int8_t)(x - R), (int8_t)(y - R) });
+            return out;
+        }
+
+        // Fly the stamp towards a center `periods` periods away and see when it really touches it
+        static int measureLead(const MoverStamp& st, int periods) {
+            Cells cells(st.shape.cells, st.shape.cells + st.shape.count);
+            int cx = st.vx * periods, cy = st.vy * periods;
+            int anchor_tick = periods * st.period - st.phase;
+
+            for (int t = 1; t <= anchor_tick; ++t) {
+                cells = lifeStep(cells);
+                for (auto p : cells)
+                    if (std::abs(p.dx - cx) <= 1 && std::abs(p.dy - cy) <= 1)
+                        return anchor_tick - t;
+            }
+            return 0;
+        }
+
+        // k quarter turns, then optional mirror across the vertical axis
+        static void orient(int& x, int& y, int rot, bool mirror) {
+            for (int r = 0; r < rot; ++r) {
+                int tmp = x;
+                x = -y;
+                y = tmp;
+            }
+            if (mirror) x = -x;
+        }
+
+        PatternLibrary() {
+            for (const auto& pat : MOVER_PATTERNS) {
+                Cells phase_cells(pat.cells, pat.cells + pat.count);
+
+                for (int phase = 0; phase < pat.period; ++phase) {
+                    // Intermediate phases can be fatter than the base one
+                    if (phase_cells.size() <= 10) {
+                        for (int o = 0; o < 8; ++o) {
+                            MoverStamp st;
+                            st.period = pat.period;
+                            st.phase = phase;
+                            st.vx = pat.vx; st.vy = pat.vy;
+                            orient(st.vx, st.vy, o & 3, o >= 4);
+
+                            for (auto p : phase_cells) {
+                                int x = p.dx, y = p.dy;
+                                orient(x, y, o & 3, o >= 4);
+                                st.shape.addPoint((int8_t)x, (int8_t)y);
+                            }
+                            st.lead = measureLead(st, maxPeriods(st));
+                            stamps.push_back(st);
+                        }
+                    }
+                    phase_cells = lifeStep(phase_cells);
+                }
+            }
+        }
+
+    public:
+        static const PatternLibrary& get() {
+            static const PatternLibrary lib;
+            return lib;
+        }
+
+        const std::vector<MoverStamp>& all() const { return stamps; }
+
+        // Anchor for a stamp to reach the 3x3 center after `periods` full periods
+        static void aimAtCenter(const MoverStamp& st, int periods, int& x, int& y) {
+            x = 12 - st.vx * periods;
+            y = 12 - st.vy * periods;
+        }
+
+        // Tick of the first hit when nothing else is on the board
+        static int timeOfArrival(const MoverStamp& st, int periods) {
+            return periods * st.period - st.phase - st.lead;
+        }
+
+        // How many periods fit between the board edge and the center for this stamp
+        static int maxPeriods(const MoverStamp& st) {
+            int speed = (std::max)(std::abs(st.vx), std::abs(st.vy));
+            return speed > 0 ? 10 / speed : 0;
+        }
+
+        // Closer than this and the stamp already sits on the center at tick 0
+        static int minPeriods(const MoverStamp& st) {
+            return (st.phase + st.lead + st.period) / st.period;
+        }
+
+        // Random distance in periods that arrives at `target_tick` or later, since a later hit is
+        // worth more mana. If the stamp can't get there that late, the latest it can
+        static int choosePeriods(const MoverStamp& st, int target_tick, std::mt19937& rng) {
+            int first = minPeriods(st), last = maxPeriods(st);
+            while (first < last && timeOfArrival(st, first) < target_tick)
+                ++first;
+            return first + (int)(rng() % (last - first + 1));
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,395 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <immintrin.h>
+#include <intrin.h>
+
+#include "Genome.hpp"
+#include "EvolutionManager.hpp"
+#include "PatternLibrary.hpp"
+
+
+namespace Dandelifeon {
+    // Children of one parent in structure-of-arrays layout. Every field is a row of LANES int8
+    // values, one per child, so one AVX2 register holds that field for the whole population.
+    // Positional mutations (types 0..3) and the coordinate math of rasterization run on all
+    // children at once, the other mutation types are applied per child in place.
+    // Boards are written into one contiguous block that the worker evaluates in order
+    class Population {
+    public:
+        static constexpr int LANES = 32;
+        static constexpr int MAX_ORGANS = 15;
+        static constexpr int MAX_CELLS = 10;
+
+    private:
+        alignas(32) int8_t org_x[MAX_ORGANS][LANES];
+        alignas(32) int8_t org_y[MAX_ORGANS][LANES];
+        alignas(32) int8_t obstacle[MAX_ORGANS][LANES];
+        alignas(32) int8_t cell_count[MAX_ORGANS][LANES];
+        alignas(32) int8_t cell_dx[MAX_ORGANS][MAX_CELLS][LANES];
+        alignas(32) int8_t cell_dy[MAX_ORGANS][MAX_CELLS][LANES];
+        alignas(32) int8_t organ_count[LANES];
+        alignas(32) int8_t symmetric[LANES];
+        alignas(32) int8_t last_mutation[LANES];
+
+        // Per round: positional mutation of every lane (type -1 - nothing to do in the SIMD pass)
+        alignas(32) int8_t type[LANES];
+        alignas(32) int8_t target[LANES];
+        alignas(32) int8_t shift_x[LANES];
+        alignas(32) int8_t shift_y[LANES];
+        alignas(32) int8_t point[LANES];
+
+        Genome parent; // mutation weights, shared by every child
+        int lanes = 0;
+
+        static void broadcast(int8_t* row, int8_t v) {
+            _mm256_store_si256((__m256i*)row, _mm256_set1_epi8(v));
+        }
+
+        static __m256i load(const int8_t* row) { return _mm256_load_si256((const __m256i*)row); }
+        static void save(int8_t* row, __m256i v) { _mm256_store_si256((__m256i*)row, v); }
+
+        static __m256i clamp(__m256i v, int lo, int hi) {
+            return _mm256_min_epi8(_mm256_max_epi8(v, _mm256_set1_epi8((int8_t)lo)), _mm256_set1_epi8((int8_t)hi));
+        }
+
+        bool hasLife(int l) const {
+            for (int o = 0; o < organ_count[l]; ++o)
+                if (!obstacle[o][l]) return true;
+            return false;
+        }
+
+        void copyOrgan(int l, int from, int to) {
+            org_x[to][l] = org_x[from][l];
+            org_y[to][l] = org_y[from][l];
+            obstacle[to][l] = obstacle[from][l];
+            cell_count[to][l] = cell_count[from][l];
+            for (int c = 0; c < MAX_CELLS; ++c) {
+                cell_dx[to][c][l] = cell_dx[from][c][l];
+                cell_dy[to][c][l] = cell_dy[from][c][l];
+            }
+        }
+
+        // Last organ takes the freed slot, like EvolutionManager does it
+        void removeOrgan(int l, int o) {
+            copyOrgan(l, organ_count[l] - 1, o);
+            organ_count[l]--;
+        }
+
+        void appendOrgan(int l, const Structure& s) {
+            int o = organ_count[l]++;
+            org_x[o][l] = s.x;
+            org_y[o][l] = s.y;
+            obstacle[o][l] = s.isObstacle ? 1 : 0;
+            cell_count[o][l] = s.count;
+            for (int c = 0; c < MAX_CELLS; ++c) {
+                cell_dx[o][c][l] = s.cells[c].dx;
+                cell_dy[o][c][l] = s.cells[c].dy;
+            }
+        }
+
+        // Types 4..9 of EvolutionManager::mutate on one lane, touching only the bytes they change
+        void mutateLane(int l, int t, int o, std::mt19937& rng, const Bitboard& footprint, int target_tick) {
+            switch (t) {
+            case 4: // Mirroring relative to mass center
+            {
+                bool axis_x = rng() % 2 == 0;
+                bool axis_y = rng() % 2 == 0;
+                for (int c = 0; c < cell_count[o][l]; ++c) {
+                    if (axis_x) cell_dx[o][c][l] = (int8_t)-cell_dx[o][c][l];
+                    if (axis_y) cell_dy[o][c][l] = (int8_t)-cell_dy[o][c][l];
+                }
+            }
+            break;
+
+            case 5: // Invert one cell
+            {
+                int count = cell_count[o][l];
+                bool remove = (count >= 10) || (count > 1 && rng() % 2 == 0);
+
+                if (remove) {
+                    cell_count[o][l]--;
+                }
+                else {
+                    int8_t dx = (int8_t)((int)(rng() % 3) - 1);
+                    int8_t dy = (int8_t)((int)(rng() % 3) - 1);
+                    cell_dx[o][count][l] = dx;
+                    cell_dy[o][count][l] = dy;
+                    cell_count[o][l]++;
+                }
+
+                if (cell_count[o][l] == 0) removeOrgan(l, o);
+            }
+            break;
+
+            case 6: // Toggle Symmetry
+                symmetric[l] ^= 1;
+                break;
+
+            case 7: // invert wall
+            {
+                if (rng() % 2 == 0) {
+                    for (int i = 0; i < organ_count[l]; ++i) {
+                        if (obstacle[i][l]) {
+                            removeOrgan(l, i);
+                            break;
+                        }
+                    }
+                }
+                else if (organ_count[l] < MAX_ORGANS) {
+                    Structure wall;
+                    wall.isObstacle = true;
+                    wall.x = rng() % 25;
+                    wall.y = rng() % 25;
+                    wall.addPoint(0, 0);
+                    appendOrgan(l, wall);
+                }
+            }
+            break;
+
+            case 8: // Smart Obstacle
+            {
+                if (organ_count[l] >= MAX_ORGANS) break;
+
+                for (int k = 0; k < 20; ++k) {
+                    int ty = 1 + rng() % 25;
+                    if (footprint.data[ty] == 0) continue;
+
+                    int tx = rng() % 25;
+                    if (footprint.data[ty] & (1 << tx)) {
+                        Structure obs;
+                        obs.x = (int8_t)tx;
+                        obs.y = (int8_t)(ty - 1);
+                        obs.isObstacle = true;
+                        obs.addPoint(0, 0);
+                        appendOrgan(l, obs);
+                        break;
+                    }
+                }
+            }
+            break;
+
+            case 9: // Aimed mover
+            {
+                if (organ_count[l] >= MAX_ORGANS) break;
+
+                const auto& stamps = PatternLibrary::get().all();
+                const MoverStamp& st = stamps[rng() % stamps.size()];
+
+                int periods = PatternLibrary::choosePeriods(st, target_tick, rng);
+                int x, y;
+                PatternLibrary::aimAtCenter(st, periods, x, y);
+
+                Structure mover = st.shape;
+                mover.x = (int8_t)x;
+                mover.y = (int8_t)y;
+                mover.isObstacle = false;
+                appendOrgan(l, mover);
+            }
+            break;
+            }
+        }
+
+        // Types 0..3 of EvolutionManager::mutate on every lane at once. Only lanes and organs the
+        // mutation touches are written, anything else keeps its bytes (aimed movers can sit off the board)
+        void shiftLanes() {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i edge = _mm256_set1_epi8(24);
+
+            __m256i t = load(type), tgt = load(target), n = load(organ_count);
+            __m256i dx = load(shift_x), dy = load(shift_y), pt = load(point);
+
+            __m256i board_shift = _mm256_cmpeq_epi8(t, zero);
+            __m256i organ_shift = _mm256_cmpeq_epi8(t, _mm256_set1_epi8(1));
+            __m256i cell_shift = _mm256_cmpeq_epi8(t, _mm256_set1_epi8(2));
+            __m256i mirror = _mm256_cmpeq_epi8(t, _mm256_set1_epi8(3));
+
+            for (int o = 0; o < MAX_ORGANS; ++o) {
+                __m256i used = _mm256_cmpgt_epi8(n, _mm256_set1_epi8((int8_t)o));
+                __m256i sel = _mm256_and_si256(_mm256_cmpeq_epi8(tgt, _mm256_set1_epi8((int8_t)o)), used);
+                __m256i life = _mm256_cmpeq_epi8(load(obstacle[o]), zero);
+
+                __m256i move = _mm256_or_si256(_mm256_and_si256(board_shift, used), _mm256_and_si256(_mm256_and_si256(organ_shift, sel), life));
+                __m256i flip = _mm256_and_si256(mirror, sel);
+
+                __m256i x = load(org_x[o]), y = load(org_y[o]);
+                x = _mm256_blendv_epi8(x, clamp(_mm256_add_epi8(x, dx), 0, 24), move);
+                y = _mm256_blendv_epi8(y, clamp(_mm256_add_epi8(y, dy), 0, 24), move);
+                x = _mm256_blendv_epi8(x, _mm256_sub_epi8(edge, x), flip);
+                y = _mm256_blendv_epi8(y, _mm256_sub_epi8(edge, y), flip);
+                save(org_x[o], x);
+                save(org_y[o], y);
+
+                __m256i cell_sel = _mm256_and_si256(_mm256_and_si256(cell_shift, sel), life);
+                if (_mm256_testz_si256(cell_sel, cell_sel)) continue;
+
+                for (int c = 0; c < MAX_CELLS; ++c) {
+                    __m256i m = _mm256_and_si256(cell_sel, _mm256_cmpeq_epi8(pt, _mm256_set1_epi8((int8_t)c)));
+                    __m256i cx = load(cell_dx[o][c]), cy = load(cell_dy[o][c]);
+                    save(cell_dx[o][c], _mm256_blendv_epi8(cx, clamp(_mm256_add_epi8(cx, dx), -5, 5), m));
+                    save(cell_dy[o][c], _mm256_blendv_epi8(cy, clamp(_mm256_add_epi8(cy, dy), -5, 5), m));
+                }
+            }
+        }
+
+    public:
+        // Evaluation block, lane i holds child i
+        Bitboard life[LANES];
+        Bitboard walls[LANES];
+
+        int size() const { return lanes; }
+
+        // Every lane becomes a copy of `p`
+        void fill(const Genome& p, int n) {
+            parent = p;
+            lanes = (std::min)(n, LANES);
+
+            for (int o = 0; o < MAX_ORGANS; ++o) {
+                const Structure& s = p.organs[o];
+                broadcast(org_x[o], s.x);
+                broadcast(org_y[o], s.y);
+                broadcast(obstacle[o], s.isObstacle ? 1 : 0);
+                broadcast(cell_count[o], s.count);
+                for (int c = 0; c < MAX_CELLS; ++c) {
+                    broadcast(cell_dx[o][c], s.cells[c].dx);
+                    broadcast(cell_dy[o][c], s.cells[c].dy);
+                }
+            }
+            broadcast(organ_count, p.organCount);
+            broadcast(symmetric, p.symmetric ? 1 : 0);
+            broadcast(last_mutation, -1);
+        }
+
+        void store(int l, const Genome& g) {
+            for (int o = 0; o < MAX_ORGANS; ++o) {
+                const Structure& s = g.organs[o];
+                org_x[o][l] = s.x;
+                org_y[o][l] = s.y;
+                obstacle[o][l] = s.isObstacle ? 1 : 0;
+                cell_count[o][l] = s.count;
+                for (int c = 0; c < MAX_CELLS; ++c) {
+                    cell_dx[o][c][l] = s.cells[c].dx;
+                    cell_dy[o][c][l] = s.cells[c].dy;
+                }
+            }
+            organ_count[l] = g.organCount;
+            symmetric[l] = g.symmetric ? 1 : 0;
+            last_mutation[l] = (int8_t)g.lastMutationType;
+        }
+
+        Genome genome(int l) const {
+            Genome g = parent;
+            for (int o = 0; o < MAX_ORGANS; ++o) {
+                Structure& s = g.organs[o];
+                s.x = org_x[o][l];
+                s.y = org_y[o][l];
+                s.isObstacle = obstacle[o][l] != 0;
+                s.count = cell_count[o][l];
+                for (int c = 0; c < MAX_CELLS; ++c) {
+                    s.cells[c].dx = cell_dx[o][c][l];
+                    s.cells[c].dy = cell_dy[o][c][l];
+                }
+            }
+            g.organCount = organ_count[l];
+            g.symmetric = symmetric[l] != 0;
+            g.lastMutationType = last_mutation[l];
+            return g;
+        }
+
+        // `rounds` mutations per child, same operators and weights as EvolutionManager::mutate
+        void mutate(std::mt19937& rng, const Bitboard& footprint, int rounds, int target_tick) {
+            for (int r = 0; r < rounds; ++r) {
+                broadcast(type, -1);
+
+                for (int l = 0; l < lanes; ++l) {
+                    if (organ_count[l] == 0 || !hasLife(l)) {
+                        Genome g = genome(l);
+                        EvolutionManager::mutate(g, rng, footprint, target_tick);
+                        store(l, g);
+                        continue;
+                    }
+
+                    int t = parent.selectMutation(rng);
+                    int o = (int)(rng() % organ_count[l]);
+                    last_mutation[l] = (int8_t)t;
+
+                    if (t <= 3) {
+                        type[l] = (int8_t)t;
+                        target[l] = (int8_t)o;
+                        shift_x[l] = (int8_t)((int)(rng() % 3) - 1);
+                        shift_y[l] = (int8_t)((int)(rng() % 3) - 1);
+                        point[l] = cell_count[o][l] > 0 ? (int8_t)(rng() % cell_count[o][l]) : -1;
+                    }
+                    else {
+                        mutateLane(l, t, o, rng, footprint, target_tick);
+
+                        // Lost its last life organ: EvolutionManager adds a fresh one
+                        if (!hasLife(l)) {
+                            Genome g = genome(l);
+                            EvolutionManager::mutate(g, rng, footprint, target_tick);
+                            store(l, g);
+                        }
+                    }
+                }
+
+                shiftLanes();
+            }
+        }
+
+        // Same boards as Genome::getLifeBoard / getObstaclesBoard. Cell coordinates and their
+        // bounds checks are done for all lanes per (organ, cell), only setting the bits is per lane
+        void rasterize() {
+            for (int l = 0; l < lanes; ++l) {
+                life[l].clear();
+                walls[l].clear();
+            }
+
+            alignas(32) int8_t rx[LANES], ry[LANES];
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i below = _mm256_set1_epi8(-1), above = _mm256_set1_epi8(25);
+            const uint32_t lane_mask = (lanes == LANES) ? 0xFFFFFFFFu : (1u << lanes) - 1;
+            const uint32_t sym = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(load(symmetric), zero));
+
+            Bitboard* boards[2] = { life, walls };
+
+            __m256i n = load(organ_count);
+            for (int o = 0; o < MAX_ORGANS; ++o) {
+                __m256i used = _mm256_cmpgt_epi8(n, _mm256_set1_epi8((int8_t)o));
+                if (_mm256_testz_si256(used, used)) break;
+
+                __m256i ox = load(org_x[o]), oy = load(org_y[o]), cnt = load(cell_count[o]);
+                uint32_t is_wall = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(load(obstacle[o]), zero));
+
+                for (int c = 0; c < MAX_CELLS; ++c) {
+                    __m256i valid = _mm256_and_si256(used, _mm256_cmpgt_epi8(cnt, _mm256_set1_epi8((int8_t)c)));
+                    if (_mm256_testz_si256(valid, valid)) break;
+
+                    __m256i x = _mm256_add_epi8(ox, load(cell_dx[o][c]));
+                    __m256i y = _mm256_add_epi8(oy, load(cell_dy[o][c]));
+                    valid = _mm256_and_si256(valid, _mm256_and_si256(_mm256_cmpgt_epi8(x, below), _mm256_cmpgt_epi8(above, x)));
+                    valid = _mm256_and_si256(valid, _mm256_and_si256(_mm256_cmpgt_epi8(y, below), _mm256_cmpgt_epi8(above, y)));
+                    save(rx, x);
+                    save(ry, y);
+
+                    uint32_t bits = (uint32_t)_mm256_movemask_epi8(valid) & lane_mask;
+                    while (bits) {
+                        unsigned long l;
+                        _BitScanForward(&l, bits);
+                        bits &= bits - 1;
+
+                        Bitboard& b = boards[(is_wall >> l) & 1][l];
+                        b.data[ry[l] + 1] |= 1u << rx[l];
+                        b.data[25 - ry[l]] |= ((sym >> l) & 1) << (24 - rx[l]);
+                    }
+                }
+            }
+
+            const uint32_t center_mask = (1 << 11) | (1 << 12) | (1 << 13);
+            for (int l = 0; l < lanes; ++l) {
+                walls[l].data[12] &= ~center_mask;
+                walls[l].data[13] &= ~center_mask;
+                walls[l].data[14] &= ~center_mask;
+            }
+        }
+    };
+}
\ No newline at end of file
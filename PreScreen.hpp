@@ -0,0 +1,205 @@
+#pragma once
+#include <random>
+#include <cstring>
+#include <algorithm>
+
+#include "DandelifeonEngine.hpp"
+
+
+namespace Dandelifeon {
+    // What a PreScreen has done so far, summed over workers for the monitor
+    struct PreScreenStats {
+        bool enabled = false;
+        bool learned = false;
+        uint64_t merges = 0;
+        uint64_t learned_rejects = 0;
+        uint64_t audits = 0;
+        uint64_t audit_misses = 0;
+        int slack = 0; // widest of the summed ones
+
+        void add(const PreScreenStats& o) {
+            enabled |= o.enabled;
+            learned |= o.learned;
+            merges += o.merges;
+            learned_rejects += o.learned_rejects;
+            audits += o.audits;
+            audit_misses += o.audit_misses;
+            slack = (std::max)(slack, o.slack);
+        }
+    };
+
+    // Staged evaluation of a worker's candidates against its current parent.
+    //  1. Trajectory merge: same walls and the same board as the parent at one of the checkpoint
+    //     ticks means the rest of the run is the parent's. Its result is known without simulating,
+    //     and it can only win by fewer blocks - then it gets the full run anyway.
+    //  2. Learned: at the horizon, a candidate much farther from the center than the parent was is
+    //     dropped. Some drops are audited with a full run: an audit that would have been accepted
+    //     widens the slack, a long streak of clean audits narrows it again (never below 1).
+    // 1 is exact: nothing that could improve the parent or the front is lost.
+    // 2 can lose an improvement or a front point between audits, so it is off unless `learned` is set
+    class PreScreen {
+    private:
+        static constexpr int CHECKPOINTS = 5;
+        static constexpr int checkpoint_ticks[CHECKPOINTS] = { 0, 1, 2, 4, 8 };
+
+        struct Trajectory {
+            Bitboard walls;
+            Bitboard boards[CHECKPOINTS];
+            int reached = 0; // checkpoints recorded before the run ended
+            bool alive_h = false;
+            int distance_h = 99;
+        };
+
+        int horizon;
+        int audit_every;
+
+        int slack = 2;
+        int clean_audits = 0;
+
+        double parent_fitness = 0;
+        SimulationResult parent_res;
+        Trajectory parent, last;
+
+        SimulationState st;
+
+        static bool sameBoard(const Bitboard& a, const Bitboard& b) {
+            return std::memcmp(a.data, b.data, sizeof(a.data)) == 0;
+        }
+
+        // Candidate merged into the parent's run: the parent's outcome with our own block count.
+        // Descriptors only cover the candidate's own ticks up to the merge, so `merged` keeps it
+        // out of anything split by niche
+        SimulationResult mergedResult() const {
+            SimulationResult res = parent_res;
+            res.initial_blocks = st.res.initial_blocks;
+            res.history = st.res.history;
+            res.pheno_x = st.res.pheno_x;
+            res.pheno_y = st.res.pheno_y;
+            res.merged = true;
+
+            double blocks = (res.initial_blocks > 0) ? (double)res.initial_blocks : 1.0;
+            res.fitness = res.success ? (double)res.mana / blocks : 0;
+            return res;
+        }
+
+        // Runs to the horizon recording checkpoints. Returns true when the result is already final
+        bool runHead(const Engine& engine, const Bitboard& walls, bool screening, SimulationResult& out) {
+            bool same_walls = screening && sameBoard(walls, parent.walls);
+            last.walls = walls;
+            last.reached = 0;
+            last.alive_h = false;
+            last.distance_h = 99;
+
+            for (int k = 0; k < CHECKPOINTS; ++k) {
+                if (engine.advance(st, walls, checkpoint_ticks[k]) && st.tick < checkpoint_ticks[k]) {
+                    out = st.res;
+                    return true;
+                }
+
+                last.boards[last.reached++] = st.board();
+
+                if (same_walls && k < parent.reached && sameBoard(st.board(), parent.boards[k])
+                    && st.res.initial_blocks >= parent_res.initial_blocks) {
+                    merges++;
+                    engine.finishDescriptors(st, walls);
+                    out = mergedResult();
+                    return true;
+                }
+            }
+
+            bool done = engine.advance(st, walls, horizon);
+            last.alive_h = !done;
+            last.distance_h = done ? 99 : Engine::distanceToCenter(st.board());
+            if (done) {
+                out = st.res;
+                return true;
+            }
+            return false;
+        }
+
+    public:
+        bool enabled = true;
+        bool learned = false;
+
+        uint64_t merges = 0;
+        uint64_t learned_rejects = 0;
+        uint64_t audits = 0;
+        uint64_t audit_misses = 0;
+
+        PreScreen(int h = 25, int audit = 32) : horizon(h), audit_every(audit) {}
+
+        SimulationResult evaluate(const Engine& engine, const Bitboard& life, const Bitboard& walls, std::mt19937& rng) {
+            engine.begin(life, walls, st);
+
+            if (!enabled) {
+                engine.advance(st, walls, engine.max_ticks);
+                return st.res;
+            }
+
+            SimulationResult out;
+            if (runHead(engine, walls, true, out))
+                return out;
+
+            bool hopeless = learned && parent.alive_h && parent_fitness > 0 && last.distance_h > parent.distance_h + slack;
+
+            if (hopeless) {
+                if (rng() % audit_every != 0) {
+                    learned_rejects++;
+                    st.res.fitness = 0;
+                    st.res.success = false;
+                    return st.res;
+                }
+
+                audits++;
+                engine.advance(st, walls, engine.max_ticks);
+
+                if (st.res.fitness > parent_fitness) {
+                    audit_misses++;
+                    slack += 2;
+                    clean_audits = 0;
+                }
+                else if (++clean_audits >= 256 && slack > 1) {
+                    slack--;
+                    clean_audits = 0;
+                }
+                return st.res;
+            }
+
+            engine.advance(st, walls, engine.max_ticks);
+            return st.res;
+        }
+
+        // Full run of a new parent from outside the normal loop (reset, archive elite)
+        SimulationResult evaluateParent(const Engine& engine, const Bitboard& life, const Bitboard& walls) {
+            engine.begin(life, walls, st);
+
+            SimulationResult out;
+            if (!runHead(engine, walls, false, out)) {
+                engine.advance(st, walls, engine.max_ticks);
+                out = st.res;
+            }
+
+            acceptParent(out);
+            return out;
+        }
+
+        // The last evaluated candidate became the parent
+        void acceptParent(const SimulationResult& res) {
+            parent_fitness = res.fitness;
+            parent_res = res;
+            parent = last;
+        }
+
+        PreScreenStats stats() const {
+            PreScreenStats s;
+            s.enabled = enabled;
+            s.learned = learned;
+            s.merges = merges;
+            s.learned_rejects = learned_rejects;
+            s.audits = audits;
+            s.audit_misses = audit_misses;
+            s.slack = slack;
+            return s;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,289 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <random>
+#include <algorithm>
+
+#include "DandelifeonEngine.hpp"
+#include "Genome.hpp"
+#include "Archive.hpp"
+
+
+namespace Dandelifeon {
+    // Finds a board that Engine::step_avx2 turns into a given one, with as few cells as it can.
+    // Same board model as the engine: columns 0..24, row 0 is never alive, rows past 25 must stay
+    // empty (a genome can't draw them), walls kill everything on them. The predecessor is built row
+    // by row; each row is picked bit by bit and checked against the target one column behind,
+    // through a 512-entry table of the 3x3 neighbourhood -> next cell. Subtrees that failed are
+    // remembered by (row, the two rows above, budget), so they are never searched twice.
+    class PredecessorSearch {
+    private:
+        static constexpr uint32_t ROW_MASK = 0x1FFFFFF;
+        static constexpr uint32_t CENTER_MASK = (1 << 11) | (1 << 12) | (1 << 13);
+
+        uint8_t rule[512];
+
+        uint32_t target[27];
+        uint32_t care[27];    // output bits that must match the target (walls are don't-care)
+        uint32_t allowed[27]; // bits the predecessor may use
+        uint32_t rows[27];    // predecessor being built, rows 0 and 26 stay empty
+
+        int budget = 0;
+        uint64_t nodes = 0;
+        uint64_t max_nodes = 0;
+        bool aborted = false;
+
+        Bitboard best;
+        int best_cells = -1;
+
+        std::unordered_map<uint64_t, int> dead; // (row, a, b) -> largest budget left that failed
+
+        // 3x3 neighbourhood of column x as a 9-bit table index, column -1 reads as dead
+        static uint32_t neighbourhood(uint32_t a, uint32_t b, uint32_t c, int x) {
+            return (((a << 1) >> x) & 7) | ((((b << 1) >> x) & 7) << 3) | ((((c << 1) >> x) & 7) << 6);
+        }
+
+        bool cellOk(int r, int x, uint32_t a, uint32_t b, uint32_t c) const {
+            if (!((care[r] >> x) & 1)) return true;
+            return rule[neighbourhood(a, b, c, x)] == ((target[r] >> x) & 1);
+        }
+
+        bool tick() {
+            if (++nodes > max_nodes) aborted = true;
+            return !aborted;
+        }
+
+        // Rows up to 25 are fixed: rows 25 and 26 of the result must come out right with nothing below
+        bool finish(int used) {
+            for (int x = 0; x < 25; ++x) {
+                if (!cellOk(25, x, rows[24], rows[25], 0)) return false;
+                if (!cellOk(26, x, rows[25], 0, 0)) return false;
+            }
+
+            best.clear();
+            for (int y = 1; y <= 25; ++y) best.data[y] = rows[y];
+            best_cells = used;
+            return true;
+        }
+
+        bool solveRow(int r, int used) {
+            if (r == 25) return finish(used);
+
+            uint64_t key = ((uint64_t)r << 50) | ((uint64_t)rows[r - 1] << 25) | rows[r];
+            int left = budget - used;
+
+            auto it = dead.find(key);
+            if (it != dead.end() && it->second >= left) return false;
+
+            if (chooseRow(r, 0, 0, used)) return true;
+
+            if (!aborted) {
+                int& d = dead[key];
+                d = (std::max)(d, left);
+            }
+            return false;
+        }
+
+        // Bits below x of rows[r + 1] are in `c`, columns below x - 1 of output row r are verified
+        bool chooseRow(int r, int x, uint32_t c, int used) {
+            if (!tick()) return false;
+
+            if (x == 25) {
+                if (!cellOk(r, 24, rows[r - 1], rows[r], c)) return false;
+                rows[r + 1] = c;
+                return solveRow(r + 1, used);
+            }
+
+            for (uint32_t bit = 0; bit <= 1; ++bit) {
+                if (bit && (!((allowed[r + 1] >> x) & 1) || used >= budget)) continue;
+
+                uint32_t nc = c | (bit << x);
+                if (x >= 1 && !cellOk(r, x - 1, rows[r - 1], rows[r], nc)) continue;
+
+                if (chooseRow(r, x + 1, nc, used + (int)bit)) return true;
+                if (aborted) return false;
+            }
+            return false;
+        }
+
+        // Output row 1 doesn't pin anything above it, so rows 1 and 2 are picked together
+        bool choosePair(int x, uint32_t b, uint32_t c, int used) {
+            if (!tick()) return false;
+
+            if (x == 25) {
+                if (!cellOk(1, 24, 0, b, c)) return false;
+                rows[1] = b;
+                rows[2] = c;
+                return solveRow(2, used);
+            }
+
+            for (uint32_t bits = 0; bits < 4; ++bits) {
+                uint32_t bb = bits & 1, bc = bits >> 1;
+                if (bb && !((allowed[1] >> x) & 1)) continue;
+                if (bc && !((allowed[2] >> x) & 1)) continue;
+                if (used + (int)(bb + bc) > budget) continue;
+
+                uint32_t nb = b | (bb << x), nc = c | (bc << x);
+                if (x >= 1 && !cellOk(1, x - 1, 0, nb, nc)) continue;
+
+                if (choosePair(x + 1, nb, nc, used + (int)(bb + bc))) return true;
+                if (aborted) return false;
+            }
+            return false;
+        }
+
+    public:
+        PredecessorSearch() {
+            for (uint32_t i = 0; i < 512; ++i) {
+                int alive = (i >> 4) & 1;
+                int n = (int)__popcnt(i) - alive;
+                rule[i] = (n == 3 || (alive && n == 2)) ? 1 : 0;
+            }
+        }
+
+        // `forbid_center` keeps the predecessor off the 3x3 center (it would have scored already).
+        // Predecessor cells are only looked for within `reach` of the target's cells: a cell farther
+        // away can only matter by overcrowding, which a small predecessor hardly ever needs.
+        // Tightens the cell budget until the node limit runs out or no smaller predecessor exists
+        bool find(const Bitboard& goal, const Bitboard& walls, bool forbid_center, int reach,
+            uint64_t node_limit, Bitboard& out, int& cells) {
+            uint32_t near[27] = {};
+            for (int y = 1; y <= 25; ++y) {
+                uint32_t row = goal.data[y] & ROW_MASK;
+                for (int i = 0; i < reach; ++i) row |= (row << 1) | (row >> 1);
+                for (int yy = (std::max)(1, y - reach); yy <= (std::min)(25, y + reach); ++yy)
+                    near[yy] |= row & ROW_MASK;
+            }
+
+            for (int y = 0; y <= 26; ++y) {
+                uint32_t w = (y >= 1 && y <= 25) ? walls.data[y] : 0;
+                target[y] = (y >= 1 && y <= 25) ? goal.data[y] & ROW_MASK : 0;
+                care[y] = ~w & ROW_MASK;
+                allowed[y] = near[y] & ~w;
+                if (forbid_center && y >= 12 && y <= 14) allowed[y] &= ~CENTER_MASK;
+                rows[y] = 0;
+            }
+
+            dead.clear();
+            nodes = 0;
+            max_nodes = node_limit;
+            aborted = false;
+            best_cells = -1;
+            budget = 25 * 25;
+
+            bool found = false;
+            while (choosePair(0, 0, 0, 0)) {
+                found = true;
+                out = best;
+                cells = best_cells;
+                if (best_cells == 0) break;
+                budget = best_cells - 1;
+            }
+            return found;
+        }
+    };
+
+    // Packs boards back into organs: up to 10 cells within -5..5 of an anchor per organ
+    inline bool boardsToGenome(const Bitboard& life, const Bitboard& walls, Genome& out) {
+        out = Genome();
+        out.symmetric = false;
+
+        for (int layer = 0; layer < 2; ++layer) {
+            Bitboard left = (layer == 0) ? life : walls;
+            if (layer == 1) {
+                // Center is never a wall anyway
+                left.data[12] &= ~((1u << 11) | (1u << 12) | (1u << 13));
+                left.data[13] &= ~((1u << 11) | (1u << 12) | (1u << 13));
+                left.data[14] &= ~((1u << 11) | (1u << 12) | (1u << 13));
+            }
+
+            for (int y = 1; y <= 25; ++y) {
+                while (left.data[y]) {
+                    if (out.organCount >= 15) return false;
+
+                    unsigned long bit;
+                    _BitScanForward(&bit, left.data[y]);
+
+                    Structure s;
+                    s.isObstacle = (layer == 1);
+                    s.x = (int8_t)bit;
+                    s.y = (int8_t)(y - 1);
+
+                    for (int yy = y; yy <= (std::min)(25, y + 5) && s.count < 10; ++yy) {
+                        for (int xx = (std::max)(0, (int)bit - 5); xx <= (std::min)(24, (int)bit + 5) && s.count < 10; ++xx) {
+                            if (left.data[yy] & (1u << xx)) {
+                                s.addPoint((int8_t)(xx - (int)bit), (int8_t)(yy - y));
+                                left.data[yy] &= ~(1u << xx);
+                            }
+                        }
+                    }
+                    out.organs[out.organCount++] = s;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Extends known solutions backwards in time: a predecessor of an elite's start board hits the
+    // center one tick later, so it is worth more mana. With an empty archive it starts from a small
+    // random hit on the center instead. Every verified result goes through the archive as usual
+    inline std::atomic<uint64_t> g_reverse_found{ 0 };
+
+    inline void reverseSearchTask(Archive& archive, const Engine& engine, uint32_t seed) {
+        std::mt19937 rng(seed);
+        PredecessorSearch search;
+
+        const uint32_t center_mask = (1 << 11) | (1 << 12) | (1 << 13);
+        const int max_steps = 6;
+        const uint64_t node_limit = 2'000'000;
+
+        while (true) {
+            Genome elite;
+            Bitboard board, walls;
+            int base_ticks = 0;
+
+            if (archive.peekElite(elite, rng)) {
+                board = elite.getLifeBoard();
+                walls = elite.getObstaclesBoard();
+                board.applyObstacles(walls);
+
+                SimulationResult res = engine.run(board, walls);
+                if (!res.success) continue;
+                base_ticks = res.ticks;
+
+                // Already on the center at tick 0 - it would score at tick 1 after one more step back
+                if ((board.data[12] | board.data[13] | board.data[14]) & center_mask) continue;
+            }
+            else {
+                board.clear();
+                walls.clear();
+                int n = 1 + rng() % 3;
+                for (int i = 0; i < n; ++i)
+                    board.data[12 + rng() % 3] |= 1u << (11 + rng() % 3);
+                base_ticks = 0;
+            }
+
+            for (int step = 1; step <= max_steps; ++step) {
+                Bitboard prev;
+                int cells = 0;
+                bool found = false;
+                for (int reach = 1; reach <= 2 && !found; ++reach)
+                    found = search.find(board, walls, true, reach, node_limit, prev, cells);
+                if (!found || cells == 0) break;
+                board = prev;
+
+                Genome gen;
+                if (!boardsToGenome(board, walls, gen)) break;
+
+                // Verify on the real engine, the genome may not reproduce the boards exactly
+                SimulationResult res = engine.run(gen.getLifeBoard(), gen.getObstaclesBoard());
+                if (!res.success || res.ticks != base_ticks + step) continue;
+
+                g_reverse_found.fetch_add(1, std::memory_order_relaxed);
+                archive.submit(gen, res);
+                archive.submitPareto(gen, res);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <iomanip>
+#include <intrin.h>
+
+// Build with -DDANDELIFEON_PROFILE=1 (/DDANDELIFEON_PROFILE=1) to get the probes, otherwise they are empty
+#ifndef DANDELIFEON_PROFILE
+#define DANDELIFEON_PROFILE 0
+#endif
+
+
+namespace Dandelifeon {
+    constexpr bool PROFILING = DANDELIFEON_PROFILE != 0;
+
+    // Submit only queues the result in deferred (--deterministic) runs, the archive work is then Flush
+    enum class Phase : int { GenomeCopy, Mutate, Rasterize, Simulate, Submit, Flush, Count };
+
+    constexpr int PHASE_COUNT = (int)Phase::Count;
+
+    inline const char* const PHASE_NAMES[PHASE_COUNT] = {
+        "GenomeCopy", "Mutate", "Rasterize",
+        "Simulate", "Submit", "Flush"
+    };
+
+    // Latency histogram of one thread. Bucket i counts probes that took [2^i, 2^(i+1)) cycles.
+    // Only the owner thread writes, so plain relaxed load/store is enough and readers never block it
+    struct alignas(64) ThreadProfile {
+        static constexpr int BUCKETS = 48;
+
+        std::atomic<uint64_t> hist[PHASE_COUNT][BUCKETS];
+        std::atomic<uint64_t> cycles[PHASE_COUNT];
+        std::atomic<uint64_t> samples[PHASE_COUNT];
+        uint64_t iteration = 0;
+
+        ThreadProfile() {
+            for (int p = 0; p < PHASE_COUNT; ++p) {
+                for (auto& b : hist[p]) b.store(0, std::memory_order_relaxed);
+                cycles[p].store(0, std::memory_order_relaxed);
+                samples[p].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void record(Phase phase, uint64_t dt) {
+            int p = (int)phase;
+            int bucket = 0;
+            while (bucket < BUCKETS - 1 && (dt >> (bucket + 1)) != 0) bucket++;
+
+            hist[p][bucket].store(hist[p][bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            cycles[p].store(cycles[p].load(std::memory_order_relaxed) + dt, std::memory_order_relaxed);
+            samples[p].store(samples[p].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+    class Profiler {
+    private:
+        std::unique_ptr<ThreadProfile[]> threads;
+        int num_threads = 0;
+        uint64_t sample_mask = 0;
+
+        // Upper edge of the bucket holding the q-th quantile
+        static uint64_t quantile(const uint64_t* hist, uint64_t total, double q) {
+            uint64_t target = (uint64_t)(q * total), seen = 0;
+            for (int b = 0; b < ThreadProfile::BUCKETS; ++b) {
+                seen += hist[b];
+                if (seen > target) return 2ull << b;
+            }
+            return 0;
+        }
+
+    public:
+        // sample_every is rounded down to a power of two
+        void init(int n, uint64_t sample_every) {
+            num_threads = n;
+            threads = std::make_unique<ThreadProfile[]>(n);
+
+            uint64_t pow2 = 1;
+            while (pow2 * 2 <= sample_every) pow2 *= 2;
+            sample_mask = pow2 - 1;
+        }
+
+        bool active() const { return threads != nullptr; }
+
+        // Decides once per worker iteration whether its probes measure anything
+        bool sampleIteration(int id) {
+            return (threads[id].iteration++ & sample_mask) == 0;
+        }
+
+        ThreadProfile& thread(int id) { return threads[id]; }
+
+        void dump(std::ostream& out) const {
+            uint64_t hist[PHASE_COUNT][ThreadProfile::BUCKETS] = {};
+            uint64_t cycles[PHASE_COUNT] = {}, samples[PHASE_COUNT] = {};
+            uint64_t all_cycles = 0;
+
+            for (int t = 0; t < num_threads; ++t) {
+                for (int p = 0; p < PHASE_COUNT; ++p) {
+                    for (int b = 0; b < ThreadProfile::BUCKETS; ++b)
+                        hist[p][b] += threads[t].hist[p][b].load(std::memory_order_relaxed);
+                    cycles[p] += threads[t].cycles[p].load(std::memory_order_relaxed);
+                    samples[p] += threads[t].samples[p].load(std::memory_order_relaxed);
+                }
+            }
+            // Flush is timed every time, the rest one iteration in sample_mask + 1: weigh it down to match
+            double weighted[PHASE_COUNT];
+            for (int p = 0; p < PHASE_COUNT; ++p) {
+                weighted[p] = p == (int)Phase::Flush ? (double)cycles[p] / (sample_mask + 1) : (double)cycles[p];
+                all_cycles += (uint64_t)weighted[p];
+            }
+
+            out << "=== WORKER PHASE PROFILE (1 of " << (sample_mask + 1) << " iterations sampled) ===\n";
+            out << "Simulate includes the pre-screen and start-board descriptors. In deferred runs Submit only\n"
+                << "queues results; the archive submits happen in Flush, which is timed on every epoch barrier\n";
+            out << std::left << std::setw(28) << "Phase" << std::setw(12) << "Samples" << std::setw(9) << "Share"
+                << std::setw(12) << "Mean cyc" << std::setw(12) << "p50 <=" << "p99 <=\n";
+
+            for (int p = 0; p < PHASE_COUNT; ++p) {
+                double share = all_cycles ? 100.0 * weighted[p] / all_cycles : 0.0;
+                uint64_t mean = samples[p] ? cycles[p] / samples[p] : 0;
+
+                out << std::left << std::setw(28) << PHASE_NAMES[p] << std::setw(12) << samples[p]
+                    << std::setw(9) << std::fixed << std::setprecision(1) << share
+                    << std::setw(12) << mean
+                    << std::setw(12) << quantile(hist[p], samples[p], 0.5)
+                    << quantile(hist[p], samples[p], 0.99) << "\n";
+            }
+        }
+
+        // Folded stacks ("frame;frame count") for flamegraph.pl / speedscope, weighted by cycles
+        void dumpFolded(std::ostream& out) const {
+            for (int t = 0; t < num_threads; ++t) {
+                for (int p = 0; p < PHASE_COUNT; ++p) {
+                    uint64_t c = threads[t].cycles[p].load(std::memory_order_relaxed);
+                    if (c) out << "T" << t << ";workerTask;" << PHASE_NAMES[p] << " " << c << "\n";
+                }
+            }
+        }
+    };
+
+    inline Profiler g_profiler;
+
+    template<bool Enabled>
+    class ScopedProbe;
+
+    template<>
+    class ScopedProbe<false> {
+    public:
+        ScopedProbe(int, Phase, bool) {}
+    };
+
+    template<>
+    class ScopedProbe<true> {
+    private:
+        ThreadProfile* prof = nullptr;
+        Phase phase;
+        uint64_t start = 0;
+
+    public:
+        ScopedProbe(int id, Phase p, bool sampled) : phase(p) {
+            if (sampled) {
+                prof = &g_profiler.thread(id);
+                start = __rdtsc();
+            }
+        }
+
+        ~ScopedProbe() {
+            if (prof) prof->record(phase, __rdtsc() - start);
+        }
+
+        ScopedProbe(const ScopedProbe&) = delete;
+        ScopedProbe& operator=(const ScopedProbe&) = delete;
+    };
+
+    using Probe = ScopedProbe<PROFILING>;
+}
\ No newline at end of file
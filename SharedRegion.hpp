@@ -0,0 +1,138 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace Dandelifeon {
+    inline uint32_t currentProcessId() {
+#ifdef _WIN32
+        return (uint32_t)GetCurrentProcessId();
+#else
+        return (uint32_t)getpid();
+#endif
+    }
+
+    // False only when the process is known to be gone (ids can be reused, so "true" may be a stranger)
+    inline bool processAlive(uint32_t pid) {
+#ifdef _WIN32
+        HANDLE h = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)pid);
+        if (h == NULL) return GetLastError() == ERROR_ACCESS_DENIED;
+        bool alive = WaitForSingleObject(h, 0) == WAIT_TIMEOUT;
+        CloseHandle(h);
+        return alive;
+#else
+        return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+#endif
+    }
+
+    // File-backed memory mapping shared between processes.
+    // The file outlives the processes, so restarts keep whatever was written into it.
+    class SharedRegion {
+    private:
+        void* base = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = NULL;
+        bool exclusive = false;
+#else
+        int fd = -1;
+#endif
+
+    public:
+        SharedRegion() = default;
+        SharedRegion(const SharedRegion&) = delete;
+        SharedRegion& operator=(const SharedRegion&) = delete;
+
+        ~SharedRegion() { close(); }
+
+        // New files (or the grown tail of short ones) come back zero-filled
+        bool open(const std::string& path, size_t size) {
+            close();
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (file == INVALID_HANDLE_VALUE) return false;
+
+            mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE,
+                (DWORD)((unsigned long long)size >> 32), (DWORD)(size & 0xFFFFFFFF), NULL);
+            if (mapping == NULL) { close(); return false; }
+
+            base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+            if (base == nullptr) { close(); return false; }
+#else
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0666);
+            if (fd < 0) return false;
+
+            struct stat st;
+            if (fstat(fd, &st) != 0) { close(); return false; }
+            if ((size_t)st.st_size < size && ftruncate(fd, (off_t)size) != 0) { close(); return false; }
+
+            void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) { close(); return false; }
+            base = p;
+#endif
+            length = size;
+            return true;
+        }
+
+        void close() {
+#ifdef _WIN32
+            if (base) UnmapViewOfFile(base);
+            if (mapping != NULL) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            mapping = NULL;
+            file = INVALID_HANDLE_VALUE;
+            exclusive = false;
+#else
+            if (base) munmap(base, length);
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+#endif
+            base = nullptr;
+            length = 0;
+        }
+
+        // Every process holds a shared lock on the open file, so the exclusive one is only granted
+        // to a process that has the file to itself. The OS drops both when the process dies
+        bool lockExclusive() {
+#ifdef _WIN32
+            OVERLAPPED ov = {};
+            ov.OffsetHigh = 1; // past anything mapped
+            exclusive = LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &ov) != 0;
+            return exclusive;
+#else
+            return flock(fd, LOCK_EX | LOCK_NB) == 0;
+#endif
+        }
+
+        // Waits for whoever holds the exclusive lock to finish
+        void lockShared() {
+#ifdef _WIN32
+            OVERLAPPED ov = {};
+            ov.OffsetHigh = 1;
+            if (exclusive) UnlockFileEx(file, 0, 1, 0, &ov);
+            exclusive = false;
+            LockFileEx(file, 0, 0, 1, 0, &ov);
+#else
+            flock(fd, LOCK_SH);
+#endif
+        }
+
+        void* data() const { return base; }
+        size_t size() const { return length; }
+    };
+}
\ No newline at end of file
@@ -1,22 +1,82 @@
 #pragma once
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <vector>
+#include <functional>
 
 #include "Genome.hpp"
 #include "DandelifeonEngine.hpp"
 #include "Archive.hpp"
 #include "EvolutionManager.hpp"
+#include "ParetoFront.hpp"
+#include "Profiler.hpp"
+#include "PreScreen.hpp"
+#include "Population.hpp"
 
 
 namespace Dandelifeon {
     inline std::unique_ptr<std::atomic<long>[]> g_thread_mana;
     inline std::unique_ptr<std::atomic<int>[]> g_thread_blocks;
     inline std::atomic<uint64_t> g_total_iters{ 0 };
+    inline bool g_prescreen_enabled = true;
+    inline bool g_prescreen_learned = false;
+    inline int g_batch_size = 1; // children per generation, 1 - the plain (1+1) loop
 
-    void workerTask(int id, Archive& archive, const Engine& engine) {
-        std::mt19937 rng(std::random_device{}() + id);
+    // Every worker's PreScreen counters, refreshed now and then for the monitor. Empty - nobody reads them
+    inline std::vector<PreScreenStats> g_thread_screen;
+    inline std::mutex g_screen_mtx;
+
+    inline PreScreenStats preScreenTotals() {
+        std::lock_guard<std::mutex> lock(g_screen_mtx);
+        PreScreenStats total;
+        for (const auto& s : g_thread_screen) total.add(s);
+        return total;
+    }
+
+    // One (1+1) evolution line, or (1+lambda) with a batch size above 1. In deferred mode nothing
+    // touches the archive between flush() calls, so the driver decides when (and in which order)
+    // workers meet there. Either way one step() is one candidate evaluation
+    class Worker {
+    private:
+        struct PendingSubmit {
+            Genome genome;
+            SimulationResult res;
+            uint64_t iteration;
+            bool pareto;
+        };
+
+        int id;
+        Archive& archive;
+        const Engine& engine;
+        bool deferred;
+
+        std::mt19937 rng;
+        PreScreen screen;
+
+        // Filters Pareto candidates without touching the shared lock. With niche fronts on, a point
+        // beaten globally can still be the best of its cell, so every cell gets a filter too
+        ParetoFront local_front;
+        std::vector<ParetoFront> local_niche_fronts;
+
+        Genome current_gen, next_gen;
+        SimulationResult best_res;
+        Bitboard life, walls;
+
+        uint64_t local_iters = 0;
+        uint64_t last_improvement = 0;
 
-        auto resetGenome = [&](Genome& g) {
+        std::vector<PendingSubmit> pending;
+        bool pending_restart = false;
+
+        // (1+lambda): children of current_gen, evaluated one per step, the best one wins at the end
+        std::unique_ptr<Population> population;
+        int batch_size = 1;
+        int batch_cursor = 0;
+        int batch_best = -1;
+        SimulationResult batch_best_res;
+
+        void resetGenome(Genome& g) {
             g = Genome();
             // I'm off asym pattern cuz I didnt beluive in this
             g.symmetric = true;
@@ -31,21 +91,45 @@ namespace Dandelifeon {
                 s.addPoint((rng() % 3) - 1, (rng() % 3) - 1);
 
             g.organs[g.organCount++] = s;
-            };
+        }
 
-        Genome current_gen;
-        resetGenome(current_gen);
-        auto best_res = engine.run(current_gen.getLifeBoard(), current_gen.getObstaclesBoard());
+        void submit(const Genome& gen, const SimulationResult& res, bool pareto) {
+            if (deferred) {
+                pending.push_back({ gen, res, local_iters, pareto });
+                return;
+            }
 
-        uint64_t local_iters = 0;
-        uint64_t last_improvement = 0;
+            if (pareto) archive.submitPareto(gen, res);
+            else archive.submit(gen, res);
+        }
 
-        while (true) {
-            local_iters++;
-            g_total_iters.fetch_add(1, std::memory_order_relaxed);
+        // Merged results don't know their real niche, only the global front takes them
+        bool nicheFiltered(const SimulationResult& res) const {
+            return !local_niche_fronts.empty() && !res.merged;
+        }
+
+        bool paretoCandidate(const SimulationResult& res) const {
+            if (!res.success) return false;
+            if (!local_front.dominated(res.mana, res.initial_blocks, res.ticks)) return true;
 
-            Genome next_gen = current_gen;
+            return nicheFiltered(res)
+                && !local_niche_fronts[Archive::nicheIndex(res)].dominated(res.mana, res.initial_blocks, res.ticks);
+        }
+
+        void keepParetoCandidate(const Genome& gen, const SimulationResult& res) {
+            local_front.insert(gen, res);
+            if (nicheFiltered(res))
+                local_niche_fronts[Archive::nicheIndex(res)].insert(gen, res);
+        }
 
+        // Results that can reach the archive need their start-board descriptors filled in
+        bool mayKeep(const SimulationResult& res) const {
+            if (res.fitness > best_res.fitness) return true;
+            if (!res.success) return false;
+            return nicheFiltered(res) || !local_front.dominated(res.mana, res.initial_blocks, res.ticks);
+        }
+
+        int mutationCount() const {
             int stagnation = (int)(local_iters - last_improvement);
             int mutation_count = 1;
 
@@ -53,40 +137,199 @@ namespace Dandelifeon {
                 mutation_count = 3;
             if (stagnation > 5'000'000)
                 mutation_count = 10;
+            return mutation_count;
+        }
+
+        // current_gen and the screen's parent are already the new parent
+        void improved(const SimulationResult& res, bool sampled) {
+            best_res = res;
+            last_improvement = local_iters;
+            current_gen.rewardLastMutation();
+
+            g_thread_mana[id].store(res.mana);
+            g_thread_blocks[id].store(res.initial_blocks);
+
+            if (res.fitness > 10.0) {
+                Probe probe(id, Phase::Submit, sampled);
+                submit(current_gen, res, false);
+            }
+        }
 
-            for (int i = 0; i < mutation_count; ++i) {
-                EvolutionManager::mutate(next_gen, rng, best_res.history);
+        void stepSingle(bool sampled) {
+            {
+                Probe probe(id, Phase::GenomeCopy, sampled);
+                next_gen = current_gen;
             }
 
-            auto res = engine.run(next_gen.getLifeBoard(), next_gen.getObstaclesBoard());
+            {
+                Probe probe(id, Phase::Mutate, sampled);
+                int mutation_count = mutationCount();
+                for (int i = 0; i < mutation_count; ++i) {
+                    EvolutionManager::mutate(next_gen, rng, best_res.history, best_res.ticks);
+                }
+            }
+
+            {
+                Probe probe(id, Phase::Rasterize, sampled);
+                life = next_gen.getLifeBoard();
+                walls = next_gen.getObstaclesBoard();
+            }
+
+            SimulationResult res;
+            {
+                Probe probe(id, Phase::Simulate, sampled);
+                res = screen.evaluate(engine, life, walls, rng);
+                if (mayKeep(res)) engine.startDescriptors(res, life, walls);
+            }
 
             if (res.fitness > best_res.fitness) {
                 current_gen = next_gen;
-                best_res = res;
-                last_improvement = local_iters;
-                current_gen.rewardLastMutation();
+                screen.acceptParent(res);
+                improved(res, sampled);
+            }
+
+            if (paretoCandidate(res)) {
+                keepParetoCandidate(next_gen, res);
 
-                g_thread_mana[id].store(res.mana);
-                g_thread_blocks[id].store(res.initial_blocks);
+                Probe probe(id, Phase::Submit, sampled);
+                submit(next_gen, res, true);
+            }
+        }
 
-                if (res.fitness > 10.0) {
-                    engine.getPhenotype(next_gen.getLifeBoard(), res.pheno_x, res.pheno_y);
-                    archive.submit(current_gen, res);
+        void stepBatch(bool sampled) {
+            if (batch_cursor == population->size()) {
+                {
+                    Probe probe(id, Phase::GenomeCopy, sampled);
+                    population->fill(current_gen, batch_size);
                 }
+                {
+                    Probe probe(id, Phase::Mutate, sampled);
+                    population->mutate(rng, best_res.history, mutationCount(), best_res.ticks);
+                }
+                {
+                    Probe probe(id, Phase::Rasterize, sampled);
+                    population->rasterize();
+                }
+                batch_cursor = 0;
+                batch_best = -1;
+            }
+
+            int lane = batch_cursor++;
+            const Bitboard& child_life = population->life[lane];
+            const Bitboard& child_walls = population->walls[lane];
+
+            SimulationResult res;
+            {
+                Probe probe(id, Phase::Simulate, sampled);
+                res = screen.evaluate(engine, child_life, child_walls, rng);
+                if (mayKeep(res)) engine.startDescriptors(res, child_life, child_walls);
+            }
+
+            if (res.fitness > best_res.fitness && (batch_best < 0 || res.fitness > batch_best_res.fitness)) {
+                batch_best = lane;
+                batch_best_res = res;
+            }
+
+            if (paretoCandidate(res)) {
+                Genome child = population->genome(lane);
+                keepParetoCandidate(child, res);
+
+                Probe probe(id, Phase::Submit, sampled);
+                submit(child, res, true);
+            }
+
+            if (batch_cursor == population->size() && batch_best >= 0) {
+                current_gen = population->genome(batch_best);
+                // The screen compares against the parent's trajectory, which is the winner's now
+                screen.evaluateParent(engine, population->life[batch_best], population->walls[batch_best]);
+                improved(batch_best_res, sampled);
+            }
+        }
+
+        void restart() {
+            // Children of the old parent are dropped
+            if (population) batch_cursor = population->size();
+
+            if (archive.getElite(current_gen, rng)) {
+                best_res = screen.evaluateParent(engine, current_gen.getLifeBoard(), current_gen.getObstaclesBoard());
+                last_improvement = local_iters;
+            }
+            else {
+                resetGenome(current_gen);
+                best_res = screen.evaluateParent(engine, current_gen.getLifeBoard(), current_gen.getObstaclesBoard());
+                last_improvement = local_iters;
+            }
+        }
+
+    public:
+        Worker(int worker_id, Archive& a, const Engine& e, uint32_t seed, bool defer)
+            : id(worker_id), archive(a), engine(e), deferred(defer), rng(seed) {
+            resetGenome(current_gen);
+            screen.enabled = g_prescreen_enabled;
+            screen.learned = g_prescreen_learned;
+
+            if (archive.hasNicheFronts()) local_niche_fronts.resize(400);
+
+            batch_size = (std::clamp)(g_batch_size, 1, Population::LANES);
+            if (batch_size > 1) population = std::make_unique<Population>();
+
+            best_res = screen.evaluateParent(engine, current_gen.getLifeBoard(), current_gen.getObstaclesBoard());
+        }
+
+        uint64_t iterations() const { return local_iters; }
+
+        void step() {
+            local_iters++;
+            g_total_iters.fetch_add(1, std::memory_order_relaxed);
+
+            bool sampled = false;
+            if constexpr (PROFILING)
+                sampled = g_profiler.sampleIteration(id);
+
+            int stagnation = (int)(local_iters - last_improvement);
+
+            if (population) stepBatch(sampled);
+            else stepSingle(sampled);
+
+            if ((local_iters & 0xFFFF) == 0 && id < (int)g_thread_screen.size()) {
+                std::lock_guard<std::mutex> lock(g_screen_mtx);
+                g_thread_screen[id] = screen.stats();
             }
 
-            
             if (stagnation > 500'000'000) {
-                if (archive.getElite(current_gen, rng)) {
-                    best_res = engine.run(current_gen.getLifeBoard(), current_gen.getObstaclesBoard());
-                    last_improvement = local_iters;
+                if (deferred) pending_restart = true;
+                else restart();
+            }
+        }
+
+        // Deferred mode: hand the archive everything gathered since the last flush
+        // `observer` sees every archive submit: worker id, the worker's iteration, result
+        void flush(const std::function<void(int, uint64_t, const SimulationResult&)>& observer = nullptr) {
+            // Once per epoch, rare enough to time every one
+            Probe probe(id, Phase::Flush, true);
+
+            for (const auto& p : pending) {
+                if (p.pareto) {
+                    archive.submitPareto(p.genome, p.res);
                 }
                 else {
-                    resetGenome(current_gen);
-                    best_res = engine.run(current_gen.getLifeBoard(), current_gen.getObstaclesBoard());
-                    last_improvement = local_iters;
+                    archive.submit(p.genome, p.res);
+                    if (observer) observer(id, p.iteration, p.res);
                 }
             }
+            pending.clear();
+
+            if (pending_restart) {
+                pending_restart = false;
+                restart();
+            }
         }
+    };
+
+    void workerTask(int id, Archive& archive, const Engine& engine) {
+        Worker worker(id, archive, engine, std::random_device{}() + id, false);
+
+        while (true)
+            worker.step();
     }
 }
\ No newline at end of file
@@ -1,11 +1,17 @@
 ﻿// #include "Threads.hpp"
 #include <windows.h>
 
+#include <string>
+#include <fstream>
+
 #include "Leaderboard.hpp"
 #include "Worker.hpp"
+#include "DeterministicRun.hpp"
+#include "PredecessorSearch.hpp"
+#include "Descriptors.hpp"
 
 
-int main() {
+int main(int argc, char** argv) {
 #ifdef _WIN32
     HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
     DWORD dwMode = 0;
@@ -16,8 +22,80 @@ int main() {
 
     int num_threads = 7; // Number of logical cores
     Dandelifeon::Archive archive;
+
+    std::string shared_path;
+    uint64_t profile_every = 64;
+    bool niche_fronts = false;
+    bool deterministic = false;
+    bool reverse = false;
+    std::string descriptor_names[2] = { "density", "row_spread" };
+    Dandelifeon::RunConfig run_cfg;
+
+    // --shared <file>        keep the archive in a file mapped by every solver process on this host
+    // --niche-fronts         besides the global Pareto front keep one in every MAP-Elites cell
+    // --profile-every <n>    sample one worker iteration of n (only in DANDELIFEON_PROFILE builds)
+    // --no-prescreen         give every candidate the full run (the Pareto front then sees all of them)
+    // --prescreen-learned    also drop candidates that look hopeless at the horizon (audited, not exact)
+    // --descriptors <x>,<y> MAP-Elites axes, see Descriptors.hpp (default density,row_spread)
+    // --reverse            one extra thread extending archive solutions backwards in time
+    // --batch <n>            (1+n) selection with n children per generation in SIMD batches (max 32)
+    // --threads <n>
+    // --deterministic        headless reproducible run, ends with a JSON summary. Takes
+    //                        --seed <n> --iters <n> --seconds <s> --epoch <n> --json <file>
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--shared" && has_value) shared_path = argv[++i];
+        else if (arg == "--niche-fronts") niche_fronts = true;
+        else if (arg == "--profile-every" && has_value) profile_every = std::stoull(argv[++i]);
+        else if (arg == "--no-prescreen") Dandelifeon::g_prescreen_enabled = false;
+        else if (arg == "--prescreen-learned") Dandelifeon::g_prescreen_learned = true;
+        else if (arg == "--reverse") reverse = true;
+        else if (arg == "--descriptors" && has_value) {
+            std::string pair = argv[++i];
+            size_t comma = pair.find(',');
+            descriptor_names[0] = pair.substr(0, comma);
+            descriptor_names[1] = (comma == std::string::npos) ? descriptor_names[1] : pair.substr(comma + 1);
+        }
+        else if (arg == "--batch" && has_value) Dandelifeon::g_batch_size = std::stoi(argv[++i]);
+        else if (arg == "--threads" && has_value) num_threads = (std::max)(1, std::stoi(argv[++i]));
+        else if (arg == "--deterministic") deterministic = true;
+        else if (arg == "--seed" && has_value) run_cfg.seed = (uint32_t)std::stoul(argv[++i]);
+        else if (arg == "--iters" && has_value) run_cfg.max_iters = std::stoull(argv[++i]);
+        else if (arg == "--seconds" && has_value) run_cfg.max_seconds = std::stod(argv[++i]);
+        else if (arg == "--epoch" && has_value) run_cfg.epoch = (std::max)(1ull, std::stoull(argv[++i]));
+        else if (arg == "--json" && has_value) run_cfg.json_path = argv[++i];
+        else std::cout << "Unknown argument " << arg << "\n";
+    }
+
+    const Dandelifeon::DescriptorKernel* descriptors[2];
+    for (int axis = 0; axis < 2; ++axis) {
+        descriptors[axis] = Dandelifeon::Descriptors::find(descriptor_names[axis]);
+        if (!descriptors[axis]) {
+            std::cout << "Unknown descriptor " << descriptor_names[axis] << ", known:";
+            for (const auto& k : Dandelifeon::Descriptors::all()) std::cout << " " << k.name;
+            std::cout << "\n";
+            return 1;
+        }
+    }
+    archive.setDescriptors(descriptors[0]->id, descriptors[1]->id);
+
+    // Other processes would make the run irreproducible
+    if (!shared_path.empty() && !deterministic) {
+        if (!archive.attachShared(shared_path))
+            std::cout << "Can't attach shared archive " << shared_path << ", using private one\n";
+    }
+
+    if (niche_fronts)
+        archive.enableNicheFronts();
+
+    if constexpr (Dandelifeon::PROFILING)
+        Dandelifeon::g_profiler.init(num_threads, profile_every);
+
     Dandelifeon::Engine engine(100, 60, 50000);
-    Dandelifeon::Leaderboard ui(num_threads);
+    engine.setDescriptors(descriptors[0], descriptors[1]);
+    Dandelifeon::Leaderboard ui(num_threads, reverse);
 
     Dandelifeon::g_thread_mana = std::make_unique<std::atomic<long>[]>(num_threads);
     Dandelifeon::g_thread_blocks = std::make_unique<std::atomic<int>[]>(num_threads);
@@ -26,14 +104,45 @@ int main() {
         Dandelifeon::g_thread_mana[i].store(0);
         Dandelifeon::g_thread_blocks[i].store(0);
     }
+    if (!deterministic)
+        Dandelifeon::g_thread_screen.resize(num_threads);
+
+    if (deterministic) {
+        run_cfg.threads = num_threads;
+        int rc = Dandelifeon::runDeterministic(archive, engine, run_cfg);
+
+        if (Dandelifeon::PROFILING) {
+            std::ofstream report("profile.txt");
+            Dandelifeon::g_profiler.dump(report);
+            std::ofstream folded("profile.folded");
+            Dandelifeon::g_profiler.dumpFolded(folded);
+        }
+        return rc;
+    }
 
     std::vector<std::thread> workers;
     for (int i = 0; i < num_threads; ++i) {
         workers.emplace_back(Dandelifeon::workerTask, i, std::ref(archive), std::cref(engine));
     }
+    if (reverse)
+        workers.emplace_back(Dandelifeon::reverseSearchTask, std::ref(archive), std::cref(engine), std::random_device{}());
 
+    int frame = 0;
     while (true) {
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        ++frame;
+
+        // Every 2 s: front with full boards, skipped when nothing changed
+        if (frame % 4 == 0)
+            archive.saveFront();
+
+        // Every 10 s: per-phase breakdown and folded stacks for flamegraph.pl
+        if (Dandelifeon::PROFILING && frame % 20 == 0) {
+            std::ofstream report("profile.txt");
+            Dandelifeon::g_profiler.dump(report);
+            std::ofstream folded("profile.folded");
+            Dandelifeon::g_profiler.dumpFolded(folded);
+        }
 
         std::vector<long> mana_snap(num_threads);
         std::vector<int> blocks_snap(num_threads);
@@ -42,7 +151,8 @@ int main() {
             blocks_snap[i] = Dandelifeon::g_thread_blocks[i].load();
         }
 
-        ui.draw(mana_snap, blocks_snap, Dandelifeon::g_total_iters.load());
+        ui.draw(mana_snap, blocks_snap, Dandelifeon::g_total_iters.load(), archive.getFront(),
+            Dandelifeon::preScreenTotals(), Dandelifeon::g_reverse_found.load());
     }
 
     return 0;